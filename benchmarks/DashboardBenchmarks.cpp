@@ -0,0 +1,382 @@
+#include <benchmark/benchmark.h>
+#include <QApplication>
+#include <QFile>
+#include <QScreen>
+#include <QTemporaryFile>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <loguru.hpp>
+#include "AlertEngine.h"
+#include "AttitudeIndicator.h"
+#include "Compass.h"
+#include "RpmIndicator.h"
+#include "TrafficDisplay.h"
+#include "MainWindow.h"
+#include "FlightDataFormat.h"
+#include "MotionPredictor.h"
+#include "SyntheticFlightModel.h"
+#include "SyntheticTrafficModel.h"
+#include "TrafficStore.h"
+
+// Benchmarks for the instrument paint paths and the MainWindow update path.
+// Runs with the offscreen QPA, which is configured with one screen per
+// benchmarked device pixel ratio. Compare runs with
+//   --benchmark_out=results.json --benchmark_out_format=json
+
+static const qreal benchmark_dprs[] = { 1.0, 1.5, 2.0 };
+
+static QScreen *screenWithDpr(qreal dpr)
+{
+    for (QScreen *screen : QGuiApplication::screens()) {
+        if (qFuzzyCompare(screen->devicePixelRatio(), dpr)) {
+            return screen;
+        }
+    }
+    return nullptr;
+}
+
+// Shows a top-level widget of the given logical size on the screen with the given DPR.
+static bool prepareWidget(QWidget &widget, int size, qreal dpr, benchmark::State &state)
+{
+    QScreen *screen = screenWithDpr(dpr);
+    if (!screen) {
+        state.SkipWithError("No offscreen screen with the requested device pixel ratio");
+        return false;
+    }
+    widget.setScreen(screen);
+    widget.setGeometry(QRect(screen->geometry().topLeft(), QSize(size, size)));
+    widget.show();
+    QCoreApplication::processEvents();
+    // First paint builds the static layers
+    widget.repaint();
+    return true;
+}
+
+// Args: logical size, DPR in percent, full repaint (1) or dirty-region update (0)
+template <typename Widget, typename Animate>
+static void paintBenchmark(benchmark::State &state, Animate animate)
+{
+    Widget widget;
+    const int size = static_cast<int>(state.range(0));
+    const qreal dpr = state.range(1) / 100.0;
+    const bool fullRepaint = state.range(2) != 0;
+    if (!prepareWidget(widget, size, dpr, state)) {
+        return;
+    }
+
+    int frame = 0;
+    for (auto _ : state) {
+        animate(widget, frame++);
+        if (fullRepaint) {
+            widget.repaint();
+        } else {
+            QCoreApplication::processEvents();
+        }
+    }
+    state.counters["suppressed"] = benchmark::Counter(static_cast<double>(widget.suppressedRepaints()));
+}
+
+static void BM_AttitudeIndicatorPaint(benchmark::State &state)
+{
+    paintBenchmark<AttitudeIndicator>(state, [](AttitudeIndicator &widget, int frame) {
+        float phase = (frame % 240) / 240.0f;
+        widget.setAttitude(-30.0f + 60.0f * phase, -10.0f + 20.0f * phase);
+    });
+}
+
+static void BM_CompassPaint(benchmark::State &state)
+{
+    paintBenchmark<Compass>(state, [](Compass &widget, int frame) {
+        widget.setHeading((frame % 720) * 0.5f);
+    });
+}
+
+static void BM_RpmIndicatorPaint(benchmark::State &state)
+{
+    paintBenchmark<RpmIndicator>(state, [](RpmIndicator &widget, int frame) {
+        float phase = (frame % 400) / 400.0f;
+        widget.setRpmPercent(20.0f + 80.0f * phase);
+        widget.setThrottlePercent(100.0f * phase);
+    });
+}
+
+static void paintArguments(benchmark::internal::Benchmark *benchmark)
+{
+    for (int size : { 100, 200, 400 }) {
+        for (qreal dpr : benchmark_dprs) {
+            for (int fullRepaint : { 0, 1 }) {
+                benchmark->Args({ size, qRound(dpr * 100), fullRepaint });
+            }
+        }
+    }
+    benchmark->ArgNames({ "size", "dpr%", "full" });
+}
+
+BENCHMARK(BM_AttitudeIndicatorPaint)->Apply(paintArguments);
+BENCHMARK(BM_CompassPaint)->Apply(paintArguments);
+BENCHMARK(BM_RpmIndicatorPaint)->Apply(paintArguments);
+
+// Source that never produces data; the benchmark drives MainWindow directly.
+class BenchmarkSource : public TelemetrySource
+{
+public:
+    bool isConnected() const override { return m_connected; }
+    void connectToSim() override
+    {
+        m_connected = true;
+        emit connected();
+    }
+    void disconnectFromSim() override
+    {
+        m_connected = false;
+        emit disconnected();
+    }
+    void transmitEvent(EVENT_ID, quint32) override {}
+
+private:
+    bool m_connected = false;
+};
+
+// Samples from MSFS_DASHBOARD_BENCH_RECORDING (.fdr) if set, otherwise one
+// minute of the synthetic flight at 60 Hz.
+static const std::vector<AircraftData> &aircraftStream()
+{
+    static const std::vector<AircraftData> stream = [] {
+        std::vector<AircraftData> samples;
+        QFile file(QString::fromLocal8Bit(qgetenv("MSFS_DASHBOARD_BENCH_RECORDING")));
+        if (!file.fileName().isEmpty() && file.open(QIODevice::ReadOnly)) {
+            QByteArray bytes = file.readAll();
+            const auto *data = reinterpret_cast<const std::uint8_t *>(bytes.constData());
+            const std::size_t size = static_cast<std::size_t>(bytes.size());
+
+            FlightData::FileHeader header;
+            std::size_t offset = FlightData::readFileHeader(data, size, header);
+            FlightData::ChunkHeader chunk;
+            std::vector<std::int64_t> timestamps;
+            std::vector<double> values;
+            const bool sameChannels = offset && header.channels.size() == FlightData::aircraftChannels().size();
+            while (sameChannels && FlightData::readChunkHeader(data + offset, size - offset, chunk)
+                   && offset + FlightData::ChunkHeaderSize + chunk.payloadSize <= size) {
+                const std::uint8_t *payload = data + offset + FlightData::ChunkHeaderSize;
+                if (!FlightData::decodeChunkPayload(payload, chunk.payloadSize, chunk, header.channels, timestamps, values)) {
+                    break;
+                }
+                for (std::size_t i = 0; i < chunk.sampleCount; ++i) {
+                    AircraftData sample {};
+                    FlightData::fromChannels(&values[i * header.channels.size()], sample);
+                    samples.push_back(sample);
+                }
+                offset += FlightData::ChunkHeaderSize + chunk.payloadSize;
+            }
+            LOG_F(INFO, "Benchmark stream: %zu samples from %s", samples.size(), qPrintable(file.fileName()));
+        }
+
+        if (samples.empty()) {
+            SyntheticFlightModel model;
+            for (int i = 0; i < 60 * 60; ++i) {
+                samples.push_back(model.step(1.0 / 60.0));
+            }
+        }
+        return samples;
+    }();
+    return stream;
+}
+
+// One sim frame through MainWindow::onAircraftDataUpdated, including the
+// repaints it triggers. Arg: InstrumentRenderMode.
+static void BM_MainWindowUpdate(benchmark::State &state)
+{
+    MainWindow window(new BenchmarkSource);
+    window.setRenderMode(static_cast<InstrumentRenderMode>(state.range(0)));
+    window.resize(1280, 800);
+    window.show();
+    QCoreApplication::processEvents();
+
+    const std::vector<AircraftData> &stream = aircraftStream();
+    std::size_t index = 0;
+    for (auto _ : state) {
+        QMetaObject::invokeMethod(&window, "onAircraftDataUpdated", Qt::DirectConnection,
+                                  Q_ARG(AircraftData, stream[index]), Q_ARG(AircraftData, stream[index]));
+        QCoreApplication::processEvents();
+        index = (index + 1) % stream.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MainWindowUpdate)
+    ->Arg(static_cast<int>(InstrumentRenderMode::Widgets))
+    ->Arg(static_cast<int>(InstrumentRenderMode::Composite))
+    ->Arg(static_cast<int>(InstrumentRenderMode::Threaded))
+    ->ArgName("mode");
+
+// Prediction for one display refresh, with a new 60 Hz sample every other
+// refresh like a 120 Hz display fed by the sim.
+static void BM_MotionPredictor(benchmark::State &state)
+{
+    const std::vector<AircraftData> &stream = aircraftStream();
+    const std::int64_t sampleInterval = 1000000000LL / 60;
+    MotionPredictor predictor;
+    std::size_t index = 0;
+    std::int64_t time = 0;
+    for (auto _ : state) {
+        if (index % 2 == 0) {
+            AircraftData sample = stream[(index / 2) % stream.size()];
+            sample.received_ns = time;
+            predictor.addSample(sample);
+        }
+        benchmark::DoNotOptimize(predictor.predict(time + sampleInterval));
+        time += sampleInterval / 2;
+        ++index;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MotionPredictor);
+
+// Arg: number of synthetic aircraft. Applies one complete 4 Hz sweep per
+// iteration: every object updated, the ones that left the radius evicted
+// and their replacements inserted.
+static void BM_TrafficUpdate(benchmark::State &state)
+{
+    SyntheticTrafficModel model(static_cast<int>(state.range(0)));
+    TrafficStore store;
+    TrafficBatch batch;
+    std::int64_t time = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        model.step(0.25, 90.0, batch);
+        batch.timeNs = ++time;
+        state.ResumeTiming();
+        store.apply(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TrafficUpdate)->Arg(100)->Arg(500)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+// Arg: number of synthetic aircraft. The display query: the closest contacts
+// within 20 nm, including closure rates.
+static void BM_TrafficNearest(benchmark::State &state)
+{
+    SyntheticTrafficModel model(static_cast<int>(state.range(0)));
+    TrafficStore store;
+    TrafficBatch batch;
+    for (int sweep = 0; sweep < 40; ++sweep) {
+        model.step(0.25, 90.0, batch);
+        batch.timeNs = sweep;
+        store.apply(batch);
+    }
+    std::vector<TrafficStore::Contact> contacts;
+    for (auto _ : state) {
+        store.nearest(TrafficDisplay::MaxContacts, 20.0f, contacts);
+        benchmark::DoNotOptimize(contacts.data());
+    }
+    state.counters["contacts"] = benchmark::Counter(static_cast<double>(contacts.size()));
+}
+
+BENCHMARK(BM_TrafficNearest)->Arg(100)->Arg(500)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+// Deterministic mix of threshold, debounced, hysteresis and arithmetic rules
+// over random schema fields.
+static std::string generatedAlertRules(int count)
+{
+    std::uint32_t random = 7;
+    auto next = [&random]() {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return random;
+    };
+    std::string text;
+    char line[512];
+    for (int i = 0; i < count; ++i) {
+        const char *a = AircraftSchema::Fields[next() % AircraftSchema::FieldCount].name;
+        const char *b = AircraftSchema::Fields[next() % AircraftSchema::FieldCount].name;
+        const unsigned threshold = next() % 100;
+        switch (i % 3) {
+            case 0:
+                std::snprintf(line, sizeof(line), "rule_%d when %s > %u and %s < %u for %ums\n", i, a, threshold, b, next() % 100, next() % 3000);
+                break;
+            case 1:
+                std::snprintf(line, sizeof(line), "rule_%d \"ALERT %d\" priority %u when abs(%s - %s) > %u clear when abs(%s - %s) < %u for 1s\n",
+                              i, i, next() % 5, a, b, threshold, a, b, threshold / 2);
+                break;
+            default:
+                std::snprintf(line, sizeof(line), "rule_%d when not (%s * 2 + %s / 3 >= %u or %s == 0)\n", i, a, b, threshold, a);
+                break;
+        }
+        text += line;
+    }
+    return text;
+}
+
+// Arg: number of rules. One display frame of alert evaluation: only rules
+// reading a changed field run, plus the pending debounce timers.
+static void BM_AlertRules(benchmark::State &state)
+{
+    AlertEngine engine;
+    if (!engine.compile(generatedAlertRules(static_cast<int>(state.range(0))), "generated")) {
+        state.SkipWithError("Rules did not compile");
+        return;
+    }
+    const std::vector<AircraftData> &stream = aircraftStream();
+    std::int64_t time = 1;
+    engine.evaluate(stream[0], ~std::uint64_t(0), time);
+    std::size_t index = 1;
+    std::size_t transitions = 0;
+    for (auto _ : state) {
+        const AircraftData &previous = stream[(index - 1) % stream.size()];
+        const AircraftData &current = stream[index % stream.size()];
+        time += 1000000000LL / 60;
+        transitions += engine.evaluate(current, AircraftSchema::diff(previous, current), time).size();
+        ++index;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["instructions"] = benchmark::Counter(static_cast<double>(engine.codeSize()));
+    state.counters["transitions"] = benchmark::Counter(static_cast<double>(transitions), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_AlertRules)->Arg(10)->Arg(1000)->Arg(5000)->Unit(benchmark::kMicrosecond);
+
+// Offscreen QPA configuration with one screen per benchmarked DPR
+static bool writeOffscreenConfig(QTemporaryFile &file)
+{
+    if (!file.open()) {
+        return false;
+    }
+    QByteArray screens;
+    int x = 0;
+    for (qreal dpr : benchmark_dprs) {
+        if (!screens.isEmpty()) {
+            screens += ',';
+        }
+        screens += QString("{\"name\":\"dpr%1\",\"x\":%2,\"y\":0,\"width\":1920,\"height\":1080,"
+                           "\"logicalDpi\":96,\"logicalBaseDpi\":96,\"dpr\":%3}")
+                       .arg(qRound(dpr * 100)).arg(x).arg(dpr).toUtf8();
+        x += 1920;
+    }
+    file.write("{\"screens\":[" + screens + "]}");
+    file.close();
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+    QTemporaryFile offscreenConfig;
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && writeOffscreenConfig(offscreenConfig)) {
+        qputenv("QT_QPA_PLATFORM", "offscreen:configfile=" + QFile::encodeName(offscreenConfig.fileName()));
+    }
+
+    QApplication app(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,169 @@
+#ifndef AIRCRAFTDATA_H
+#define AIRCRAFTDATA_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Request groups a SimVar can belong to; their period and interval are
+// configured by the SimConnect client.
+enum class SimVarGroup {
+    Fast, // animated instruments, every sim frame
+    Slow, // discrete and slow-moving state
+};
+
+// Single schema for the aircraft state. The struct, the SimConnect data
+// definitions, field iteration and diffing, and the recorder channels are
+// all generated from this list, so they cannot get out of order.
+//
+//   X(type, field, SimVar, unit, group, epsilon)
+//
+// type is float (FLOAT32) or std::int32_t (INT32). Units are chosen so
+// SimConnect does the conversion, e.g. attitude arrives in degrees.
+// epsilon is the smallest change SimConnect reports for the variable.
+// The C struct in shm/msfs_telemetry_shm.h mirrors this list for other
+// processes; SharedMemoryBus fails to compile until it is updated too.
+#define AIRCRAFT_DATA_FIELDS(X) \
+    X(float, gear_total_extended_pct, "GEAR TOTAL PCT EXTENDED", "Percent", Slow, 0.0001f) \
+    X(std::int32_t, parking_brake_position, "BRAKE PARKING INDICATOR", "Bool", Slow, 0.0f) \
+    X(std::int32_t, autopilot_master, "AUTOPILOT MASTER", "Bool", Slow, 0.0f) \
+    X(float, attitude_bank_degrees, "ATTITUDE INDICATOR BANK DEGREES", "Degrees", Fast, 0.005f) \
+    X(float, attitude_pitch_degrees, "ATTITUDE INDICATOR PITCH DEGREES", "Degrees", Fast, 0.005f) \
+    X(std::int32_t, gear_handle_position, "GEAR HANDLE POSITION", "Bool", Slow, 0.0f) \
+    X(float, plane_heading_degrees_true, "PLANE HEADING DEGREES TRUE", "Degrees", Fast, 0.01f) \
+    X(std::int32_t, gear_damage_by_speed, "GEAR DAMAGE BY SPEED", "Bool", Slow, 0.0f) \
+    X(std::int32_t, gear_warning_center, "GEAR WARNING:0", "Number", Slow, 0.0f) \
+    X(std::int32_t, gear_warning_left, "GEAR WARNING:1", "Number", Slow, 0.0f) \
+    X(std::int32_t, gear_warning_right, "GEAR WARNING:2", "Number", Slow, 0.0f) \
+    X(float, gear_pos_center, "GEAR CENTER POSITION", "Percent Over 100", Slow, 0.0001f) \
+    X(float, gear_pos_left, "GEAR LEFT POSITION", "Percent Over 100", Slow, 0.0001f) \
+    X(float, gear_pos_right, "GEAR RIGHT POSITION", "Percent Over 100", Slow, 0.0001f) \
+    X(float, eng_n1_1, "TURB ENG N1:1", "Percent", Fast, 0.01f) \
+    X(float, eng_n1_2, "TURB ENG N1:2", "Percent", Fast, 0.01f) \
+    X(float, eng_n1_3, "TURB ENG N1:3", "Percent", Fast, 0.01f) \
+    X(float, eng_n1_4, "TURB ENG N1:4", "Percent", Fast, 0.01f) \
+    X(float, throttle_1, "GENERAL ENG THROTTLE LEVER POSITION:1", "Percent", Fast, 0.01f) \
+    X(float, throttle_2, "GENERAL ENG THROTTLE LEVER POSITION:2", "Percent", Fast, 0.01f) \
+    X(float, throttle_3, "GENERAL ENG THROTTLE LEVER POSITION:3", "Percent", Fast, 0.01f) \
+    X(float, throttle_4, "GENERAL ENG THROTTLE LEVER POSITION:4", "Percent", Fast, 0.01f) \
+    X(float, plane_alt_above_ground, "PLANE ALT ABOVE GROUND", "Feet", Slow, 1.0f)
+
+// Data structure to hold aircraft data received from the telemetry source.
+// The schema fields are laid out exactly like the SimConnect data definition.
+struct AircraftData {
+#define AIRCRAFT_DATA_MEMBER(type, field, simVar, unit, group, epsilon) type field;
+    AIRCRAFT_DATA_FIELDS(AIRCRAFT_DATA_MEMBER)
+#undef AIRCRAFT_DATA_MEMBER
+
+    // Latency stamps (LatencyHistogram::now()), not part of the schema:
+    // when the packet arrived and when the snapshot was handed to the UI.
+    // With an odd field count they follow 4 bytes of tail padding.
+    std::int64_t received_ns;
+    std::int64_t published_ns;
+};
+
+namespace AircraftSchema {
+
+struct Field {
+    const char *name;
+    const char *simVar;
+    const char *unit;
+    SimVarGroup group;
+    float epsilon;
+    std::size_t offset;
+    bool isInteger;
+};
+
+#define AIRCRAFT_DATA_SCHEMA_ENTRY(type, field, simVar, unit, group, epsilon) \
+    { #field, simVar, unit, SimVarGroup::group, epsilon, offsetof(AircraftData, field), std::is_integral<type>::value },
+inline constexpr Field Fields[] = { AIRCRAFT_DATA_FIELDS(AIRCRAFT_DATA_SCHEMA_ENTRY) };
+#undef AIRCRAFT_DATA_SCHEMA_ENTRY
+
+constexpr std::size_t FieldCount = sizeof(Fields) / sizeof(Fields[0]);
+constexpr std::size_t FieldSize = 4;
+// Bytes the schema fields occupy at the start of AircraftData, laid out
+// like the SimConnect data definition and msfs_telemetry_data.
+constexpr std::size_t PayloadSize = FieldCount * FieldSize;
+
+// Field indices, e.g. AircraftSchema::plane_heading_degrees_true
+enum FieldId : std::size_t {
+#define AIRCRAFT_DATA_FIELD_ID(type, field, simVar, unit, group, epsilon) field,
+    AIRCRAFT_DATA_FIELDS(AIRCRAFT_DATA_FIELD_ID)
+#undef AIRCRAFT_DATA_FIELD_ID
+};
+
+constexpr std::uint64_t bit(FieldId id)
+{
+    return std::uint64_t(1) << id;
+}
+
+#define AIRCRAFT_DATA_CHECK_TYPE(type, field, simVar, unit, group, epsilon) \
+    static_assert(std::is_same<type, float>::value || std::is_same<type, std::int32_t>::value, \
+                  #field " must be float or std::int32_t");
+AIRCRAFT_DATA_FIELDS(AIRCRAFT_DATA_CHECK_TYPE)
+#undef AIRCRAFT_DATA_CHECK_TYPE
+constexpr bool fieldsArePacked()
+{
+    for (std::size_t i = 0; i < FieldCount; ++i) {
+        if (Fields[i].offset != i * FieldSize) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(fieldsArePacked(), "Schema fields must be packed from the start of AircraftData");
+static_assert(FieldCount <= 64, "Field masks are 64 bits wide");
+
+// Value of field index as a double.
+inline double value(const AircraftData &data, std::size_t index)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&data) + Fields[index].offset;
+    if (Fields[index].isInteger) {
+        std::int32_t integer;
+        std::memcpy(&integer, bytes, sizeof(integer));
+        return integer;
+    }
+    float real;
+    std::memcpy(&real, bytes, sizeof(real));
+    return real;
+}
+
+inline void setValue(AircraftData &data, std::size_t index, double value)
+{
+    unsigned char *bytes = reinterpret_cast<unsigned char *>(&data) + Fields[index].offset;
+    if (Fields[index].isInteger) {
+        std::int32_t converted = static_cast<std::int32_t>(std::lround(value));
+        std::memcpy(bytes, &converted, sizeof(converted));
+    } else {
+        float converted = static_cast<float>(value);
+        std::memcpy(bytes, &converted, sizeof(converted));
+    }
+}
+
+// Bit i is set when field i differs between a and b.
+inline std::uint64_t diff(const AircraftData &a, const AircraftData &b)
+{
+    std::uint64_t changed = 0;
+    for (std::size_t i = 0; i < FieldCount; ++i) {
+        if (std::memcmp(reinterpret_cast<const unsigned char *>(&a) + Fields[i].offset,
+                        reinterpret_cast<const unsigned char *>(&b) + Fields[i].offset, FieldSize) != 0) {
+            changed |= std::uint64_t(1) << i;
+        }
+    }
+    return changed;
+}
+
+// Calls f(index, name, value) for every field, in schema order.
+template <typename F>
+void forEachField(const AircraftData &data, F &&f)
+{
+    for (std::size_t i = 0; i < FieldCount; ++i) {
+        f(i, Fields[i].name, value(data, i));
+    }
+}
+
+} // namespace AircraftSchema
+
+#endif // AIRCRAFTDATA_H
@@ -0,0 +1,105 @@
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include <QString>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AircraftData.h"
+
+// User-defined alert rules over the aircraft state. Rules are parsed once
+// and compiled to a small stack bytecode; evaluation is incremental: a rule
+// is only re-run when one of the schema fields it reads changed, and
+// debounce timers are kept in a pending list instead of rescanning history.
+//
+// One rule per line, '#' starts a comment:
+//
+//   name ["message"] [priority N] when <condition> [for <duration>]
+//        [clear when <condition> [for <duration>]]
+//
+// A rule becomes active once its condition held for the "for" duration. It
+// clears when the condition no longer holds or, if given, once the clear
+// condition held for its duration, which gives hysteresis. Conditions use
+// schema field names or quoted SimVar names ('PLANE ALT ABOVE GROUND'),
+// numbers, + - * /, abs(), comparisons (< <= > >= == !=), and, or, not and
+// parentheses. Durations are numbers with an optional ms, s or min suffix.
+//
+//   gear_not_down "GEAR NOT DOWN" when 'GEAR TOTAL PCT EXTENDED' < 1
+//       and plane_alt_above_ground < 1000 for 2s  (on one line)
+class AlertEngine
+{
+public:
+    struct Rule {
+        std::string name;
+        std::string message;
+        int priority = 0;
+        std::int64_t setDelayNs = 0;
+        std::int64_t clearDelayNs = 0;
+    };
+
+    // Compiles rules and adds them; a rule named like an existing one
+    // replaces it and starts over inactive, so load rules before evaluating.
+    // On a syntax error nothing is added, the error is logged with its line
+    // and column and false is returned.
+    bool compile(const std::string &text, const std::string &sourceName = "rules");
+    bool loadFile(const QString &path);
+    void clear();
+
+    std::size_t ruleCount() const { return m_rules.size(); }
+    const Rule &rule(std::size_t index) const { return m_rules[index]; }
+    // Index of the named rule, or -1.
+    int find(const std::string &name) const;
+    std::size_t codeSize() const { return m_code.size(); }
+
+    // Deactivates every rule; the next evaluate() must report all fields
+    // as changed.
+    void reset();
+    // Re-runs the rules reading a field in changedFields (AircraftSchema
+    // bits) and advances pending debounce timers. Returns the indices of the
+    // rules that became active or inactive.
+    const std::vector<std::uint32_t> &evaluate(const AircraftData &data, std::uint64_t changedFields, std::int64_t nowNs);
+    bool isActive(std::size_t index) const { return m_active[index] != 0; }
+    // Earliest pending debounce deadline, or 0 if no timer runs. Evaluating
+    // at that time with no changed fields fires it.
+    std::int64_t nextDeadline() const;
+
+    enum class Op : std::uint8_t {
+        Field, Constant, Negate, Abs, Not,
+        Add, Subtract, Multiply, Divide,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+        And, Or, Return
+    };
+    struct Instruction {
+        Op op;
+        std::uint16_t field;
+        float constant;
+    };
+    static constexpr int MaxStackDepth = 16;
+    static constexpr std::uint32_t NoCode = ~std::uint32_t(0);
+
+private:
+    bool run(std::uint32_t offset) const;
+    void update(std::uint32_t index, std::int64_t nowNs);
+    void setActive(std::uint32_t index, bool active);
+
+    std::vector<Rule> m_rules;
+    std::unordered_map<std::string, std::uint32_t> m_rule_index;
+    std::vector<Instruction> m_code;
+
+    // Per rule, in rule order
+    std::vector<std::uint64_t> m_inputs; // fields read by either condition
+    std::vector<std::uint32_t> m_set_code;
+    std::vector<std::uint32_t> m_clear_code; // NoCode without a clear condition
+    std::vector<std::uint8_t> m_set_condition;
+    std::vector<std::uint8_t> m_clear_condition;
+    std::vector<std::uint8_t> m_active;
+    std::vector<std::int64_t> m_deadline; // 0 while no timer runs
+    std::vector<std::uint8_t> m_queued; // listed in m_pending
+
+    std::vector<std::uint32_t> m_pending; // rules with a running timer
+    std::vector<std::uint32_t> m_transitions;
+    float m_values[AircraftSchema::FieldCount] = {};
+};
+
+#endif // ALERTENGINE_H
@@ -1,10 +1,10 @@
 #ifndef ATTITUDEINDICATOR_H
 #define ATTITUDEINDICATOR_H
 
-#include <QWidget>
-#include <QPainter>
+#include "InstrumentWidget.h"
+#include <QImage>
 
-class AttitudeIndicator : public QWidget
+class AttitudeIndicator : public InstrumentWidget
 {
     Q_OBJECT
 
@@ -14,17 +14,32 @@ public:
 public slots:
     void setRoll(float roll);
     void setPitch(float pitch);
+    void setAttitude(float roll, float pitch);
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
+    void drawStaticBackground(QPainter &painter) override;
+    void drawDynamicLayer(QPainter &painter) override;
+    void drawStaticForeground(QPainter &painter) override;
+    bool hasStaticForeground() const override;
+    void staticLayersRebuilt() override;
+    void captureRenderState() override;
 
 private:
-    void drawBackground(QPainter &painter);
     void drawPitchAndRoll(QPainter &painter);
-    void drawFixedSymbol(QPainter &painter);
+    void drawHorizonStrip(QPainter &painter);
+    void rebuildHorizonCache();
 
     float m_roll_degrees = 0.0f;
     float m_pitch_degrees = 0.0f;
+    // Attitude of the frame being drawn
+    float m_render_roll_degrees = 0.0f;
+    float m_render_pitch_degrees = 0.0f;
+
+    // Sky, ground and pitch ladder for the full pitch range, rendered once
+    QImage m_horizon_strip;
+    // Circular alpha mask of the dial and the scratch image it is copied into
+    QImage m_horizon_mask;
+    QImage m_horizon_buffer;
 };
 
-#endif // ATTITUDEINDICATOR_H 
\ No newline at end of file
+#endif // ATTITUDEINDICATOR_H
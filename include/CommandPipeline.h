@@ -0,0 +1,101 @@
+#ifndef COMMANDPIPELINE_H
+#define COMMANDPIPELINE_H
+
+#include <QObject>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AircraftData.h"
+#include "TelemetrySource.h"
+
+// Queues client events for the telemetry source and sends them from a
+// worker thread, so GUI slots never block on the sim connection.
+//   - set-style events (value sets, gear, flaps, engine start/stop) are
+//     coalesced per target: the first is sent at once, later ones within
+//     the window replace each other and only the latest is sent when the
+//     window closes, unless it repeats the command last sent
+//   - toggles are rate-limited; repeats within the interval are dropped
+//   - events with a matching SimVar are acknowledged when the SimVar
+//     changes accordingly, recording command to ack latency
+// The source's transmitEvent must be callable from the worker thread.
+class CommandPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::int64_t CoalesceWindowNs = 100000000;  // 100 ms
+    static constexpr std::int64_t ToggleIntervalNs = 250000000;  // 250 ms
+    static constexpr std::int64_t AckTimeoutNs = 3000000000;     // 3 s
+
+    explicit CommandPipeline(TelemetrySource *source, QObject *parent = nullptr);
+    ~CommandPipeline() override;
+
+    // Callable from any thread
+    void submit(TelemetrySource::EVENT_ID eventId, quint32 data = 0);
+    // Joins the worker; pending commands are dropped
+    void stop();
+
+public slots:
+    // Latest sim state, used to arm and complete acknowledgements
+    void observe(const AircraftData &data);
+    // Drops queued commands and outstanding acknowledgements, e.g. on disconnect
+    void clear();
+
+signals:
+    // Emitted from the worker thread
+    void acknowledged(TelemetrySource::EVENT_ID eventId, qint64 latencyNs);
+    void timedOut(TelemetrySource::EVENT_ID eventId);
+
+private:
+    enum class Kind { Coalesce, Toggle };
+    enum class Test { Equals, Differs, Rises, Falls };
+
+    struct Command {
+        TelemetrySource::EVENT_ID eventId;
+        quint32 data;
+        int key;
+    };
+
+    // Per coalescing / rate-limiting target
+    struct KeyState {
+        std::int64_t windowEnd = 0;
+        bool pending = false;
+        TelemetrySource::EVENT_ID eventId = TelemetrySource::EVENT_ID(0);
+        quint32 data = 0;
+        bool sent = false;
+        TelemetrySource::EVENT_ID sentEventId = TelemetrySource::EVENT_ID(0);
+        quint32 sentData = 0;
+    };
+
+    struct Ack {
+        TelemetrySource::EVENT_ID eventId;
+        int key;
+        AircraftSchema::FieldId field;
+        Test test;
+        double reference;
+        std::int64_t sentNs;
+        std::int64_t deadlineNs;
+    };
+
+    static Kind kindFor(TelemetrySource::EVENT_ID eventId, quint32 data, int &key);
+    bool armAck(const Command &command, std::int64_t sentNs);
+    static bool satisfied(const Ack &ack, const AircraftData &data);
+    void workerLoop();
+
+    TelemetrySource *m_source;
+
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+    std::vector<Command> m_ready;
+    std::map<int, KeyState> m_keys;
+    std::vector<Ack> m_acks;
+    AircraftData m_latest {};
+    bool m_has_latest = false;
+};
+
+#endif // COMMANDPIPELINE_H
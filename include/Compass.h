@@ -1,10 +1,10 @@
 #ifndef COMPASS_H
 #define COMPASS_H
 
-#include <QWidget>
-#include <QPainter>
+#include "InstrumentWidget.h"
+#include "ReadoutRenderer.h"
 
-class Compass : public QWidget
+class Compass : public InstrumentWidget
 {
     Q_OBJECT
 
@@ -15,12 +15,20 @@ public slots:
     void setHeading(float heading);
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
+    void drawStaticBackground(QPainter &painter) override;
+    void drawDynamicLayer(QPainter &painter) override;
+    void drawStaticForeground(QPainter &painter) override;
+    bool hasStaticForeground() const override;
+    void staticLayersRebuilt() override;
+    void captureRenderState() override;
 
 private:
-    void drawCompass(QPainter &painter);
+    void drawCompassCard(QPainter &painter);
 
     float m_heading_degrees = 0.0f;
+    float m_render_heading_degrees = 0.0f; // heading of the frame being drawn
+    QImage m_card_layer;
+    ReadoutRenderer m_heading_readout;
 };
 
-#endif // COMPASS_H 
\ No newline at end of file
+#endif // COMPASS_H
@@ -0,0 +1,18 @@
+#ifndef DASHBOARDAPPLICATION_H
+#define DASHBOARDAPPLICATION_H
+
+#include <QApplication>
+
+// QApplication that wraps layout and window repaint events in trace spans,
+// so time spent outside our own code shows up in the trace as well.
+class DashboardApplication : public QApplication
+{
+    Q_OBJECT
+
+public:
+    DashboardApplication(int &argc, char **argv);
+
+    bool notify(QObject *receiver, QEvent *event) override;
+};
+
+#endif // DASHBOARDAPPLICATION_H
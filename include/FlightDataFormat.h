@@ -0,0 +1,131 @@
+#ifndef FLIGHTDATAFORMAT_H
+#define FLIGHTDATAFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AircraftData.h"
+
+// Chunked columnar file format for recorded flights (.fdr).
+//
+//   file header   magic "MSFSFDR1", version, chunk capacity, start time,
+//                 channel table (name, codec, resolution)
+//   chunk*        magic "CHNK", sample count, first/last timestamp,
+//                 payload size, per-column byte sizes, columns
+//   index         optional, written when a recording is closed cleanly:
+//                 one entry per chunk (first/last timestamp, file offset,
+//                 sample count), then the index offset, entry count and
+//                 magic "MSFSIDX1" as a fixed-size trailer at the very end
+//
+// Inside a chunk every column is compressed on its own, Gorilla style:
+//   - timestamps (microseconds) use delta-of-delta with variable-length buckets
+//   - Xor channels store the XOR with the previous value, reusing the previous
+//     leading/trailing zero window when possible (lossless, ideal for flags)
+//   - QuantizedDelta channels are rounded to the channel resolution and stored
+//     as delta-of-delta of the resulting integers (tiny for smooth signals)
+// All integers are little endian.
+namespace FlightData {
+
+constexpr char FileMagic[8] = { 'M', 'S', 'F', 'S', 'F', 'D', 'R', '1' };
+constexpr std::uint32_t FormatVersion = 1;
+constexpr std::uint32_t ChunkMagic = 0x4B4E4843; // "CHNK"
+constexpr std::size_t ChunkHeaderSize = 28;
+constexpr int DefaultChunkCapacity = 1024;
+constexpr char IndexMagic[8] = { 'M', 'S', 'F', 'S', 'I', 'D', 'X', '1' };
+constexpr std::size_t IndexEntrySize = 28;
+constexpr std::size_t IndexTrailerSize = 20;
+
+enum class Codec : std::uint8_t {
+    Xor = 0,
+    QuantizedDelta = 1,
+};
+
+struct Channel {
+    std::string name;
+    Codec codec;
+    double resolution; // only used by QuantizedDelta
+};
+
+struct FileHeader {
+    std::uint32_t version = FormatVersion;
+    std::uint32_t chunkCapacity = DefaultChunkCapacity;
+    std::int64_t startUnixMicroseconds = 0;
+    std::vector<Channel> channels;
+};
+
+struct ChunkHeader {
+    std::uint32_t sampleCount = 0;
+    std::int64_t firstTimestamp = 0;
+    std::int64_t lastTimestamp = 0;
+    std::uint32_t payloadSize = 0;
+};
+
+struct IndexEntry {
+    std::int64_t firstTimestamp = 0;
+    std::int64_t lastTimestamp = 0;
+    std::uint64_t offset = 0; // file offset of the chunk header
+    std::uint32_t sampleCount = 0;
+};
+
+// Channel table describing AircraftData, in schema order.
+const std::vector<Channel> &aircraftChannels();
+void toChannels(const AircraftData &data, double *values);
+void fromChannels(const double *values, AircraftData &data);
+
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<std::uint8_t> &out) : m_out(out) {}
+    ~BitWriter() { flush(); }
+
+    void write(std::uint64_t value, int bits);
+    void writeBit(bool bit) { write(bit ? 1 : 0, 1); }
+    // Pads to a byte boundary
+    void flush();
+
+private:
+    std::vector<std::uint8_t> &m_out;
+    std::uint64_t m_buffer = 0;
+    int m_buffered = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const std::uint8_t *data, std::size_t size) : m_data(data), m_size(size) {}
+
+    std::uint64_t read(int bits);
+    bool readBit() { return read(1) != 0; }
+    bool overrun() const { return m_overrun; }
+
+private:
+    const std::uint8_t *m_data;
+    std::size_t m_size;
+    std::size_t m_bit = 0;
+    bool m_overrun = false;
+};
+
+void writeFileHeader(const FileHeader &header, std::vector<std::uint8_t> &out);
+// Returns the number of bytes consumed, or 0 if the data is not a valid header.
+std::size_t readFileHeader(const std::uint8_t *data, std::size_t size, FileHeader &header);
+
+// Appends one chunk. values is row-major: count rows of channels.size() values.
+void encodeChunk(const std::int64_t *timestamps, const double *values, std::size_t count,
+                 const std::vector<Channel> &channels, std::vector<std::uint8_t> &out);
+bool readChunkHeader(const std::uint8_t *data, std::size_t size, ChunkHeader &header);
+// Decodes a chunk payload (the bytes following the chunk header). Fails
+// without allocating if the sample count cannot fit the payload.
+bool decodeChunkPayload(const std::uint8_t *payload, std::size_t size, const ChunkHeader &header,
+                        const std::vector<Channel> &channels,
+                        std::vector<std::int64_t> &timestamps, std::vector<double> &values);
+
+// Appends the chunk index followed by its trailer.
+void writeIndex(const std::vector<IndexEntry> &entries, std::uint64_t indexOffset, std::vector<std::uint8_t> &out);
+// Reads the index from the trailer at the end of a whole file. Returns false
+// if the file has no (valid) index, e.g. because the recording was interrupted.
+bool readIndex(const std::uint8_t *data, std::size_t size, std::vector<IndexEntry> &entries);
+
+} // namespace FlightData
+
+#endif // FLIGHTDATAFORMAT_H
@@ -0,0 +1,80 @@
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AircraftData.h"
+#include "FlightDataFormat.h"
+
+// Records telemetry snapshots into a chunked columnar .fdr file (see
+// FlightDataFormat.h). append() is meant for TelemetrySource::snapshotDecoded
+// (Qt::DirectConnection), so every decoded sample is recorded with its
+// receive time, not the GUI delivery pattern. The producing thread only
+// copies each snapshot into the current chunk buffer; full chunks are
+// compressed and written by a background thread, and buffers are recycled
+// so steady-state recording does not allocate. The chunk index is appended
+// when recording stops.
+class FlightRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FlightRecorder(QObject *parent = nullptr);
+    ~FlightRecorder() override;
+
+    bool start(const QString &path);
+    void stop();
+    bool isRecording() const { return m_recording.load(std::memory_order_acquire); }
+
+    quint64 samplesRecorded() const { return m_samples.load(std::memory_order_relaxed); }
+
+public slots:
+    // Thread-safe against start() and stop()
+    void append(const AircraftData &data);
+
+private:
+    struct Chunk {
+        std::vector<std::int64_t> timestamps;
+        std::vector<double> values;
+        std::size_t count = 0;
+    };
+
+    std::unique_ptr<Chunk> takeFreeChunk();
+    void submitCurrentChunk();
+    void writerLoop();
+
+    std::FILE *m_file = nullptr;
+    std::vector<char> m_file_buffer;
+    std::vector<FlightData::Channel> m_channels;
+
+    // Owned by the producing thread while recording, guarded against
+    // start() and stop() by m_append_mutex
+    std::mutex m_append_mutex;
+    std::atomic<bool> m_recording { false };
+    std::int64_t m_start_ns = 0;
+    std::unique_ptr<Chunk> m_current;
+    std::atomic<quint64> m_samples { 0 };
+
+    // Shared with the writer thread
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::unique_ptr<Chunk>> m_pending;
+    std::vector<std::unique_ptr<Chunk>> m_free;
+    bool m_stopping = false;
+
+    // Owned by the writer thread while recording
+    std::vector<FlightData::IndexEntry> m_index;
+    std::uint64_t m_file_offset = 0;
+};
+
+#endif // FLIGHTRECORDER_H
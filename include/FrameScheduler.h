@@ -0,0 +1,87 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QWidget>
+#include "AircraftData.h"
+#include "MotionPredictor.h"
+
+// Coalesces incoming sim frames and hands the latest snapshot to the UI
+// once per display refresh. Sim frames arriving between two refreshes are
+// dropped (latest value wins), so the UI never renders frames nobody sees.
+// With prediction enabled, the animated channels of each frame are
+// interpolated or extrapolated to the time the frame reaches the screen, and
+// refreshes without a new sim frame still get an updated prediction until
+// it is back at the newest sample. This gives display-rate motion from a
+// slower feed. Predictions only go to the animated instruments; anything
+// that acts on the state (alerts, controls) gets the frame as received.
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // The widget's screen provides the refresh rate to pace against.
+    explicit FrameScheduler(QWidget *window, QObject *parent = nullptr);
+
+    qreal refreshRate() const { return m_refresh_rate; }
+
+    quint64 simFrames() const { return m_sim_frames; }
+    quint64 displayedFrames() const { return m_displayed_frames; }
+    // Sim frames dropped in favour of a newer one
+    quint64 coalescedFrames() const { return m_sim_frames - m_displayed_frames; }
+    // Sim frames merged into the most recent displayed frame
+    int lastFramesPerDisplay() const { return m_last_frames_per_display; }
+    int maxFramesPerDisplay() const { return m_max_frames_per_display; }
+    // Refreshes that showed a prediction without a new sim frame
+    quint64 predictedFrames() const { return m_predicted_frames; }
+
+    // Extrapolation horizon in nanoseconds; 0 shows sim frames as received.
+    void setPredictionHorizon(qint64 horizonNs) { m_predictor.setHorizon(horizonNs); }
+    qint64 predictionHorizon() const { return m_predictor.horizon(); }
+
+public slots:
+    void submit(const AircraftData &data);
+    // Drops any pending snapshot, e.g. after a disconnect
+    void reset();
+
+signals:
+    // data is the newest sim frame as received; display is the same frame
+    // with the animated channels predicted for this refresh, or data itself
+    // without prediction. Refreshes that only move the prediction repeat
+    // data with published_ns cleared in both.
+    void frameReady(const AircraftData &data, const AircraftData &display);
+
+private slots:
+    void onTick();
+    void updateRefreshRate();
+
+private:
+    void scheduleNextTick();
+    void logStatistics();
+
+    QPointer<QWidget> m_window;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qreal m_refresh_rate = 60.0;
+    qint64 m_frame_interval_ns = 0;
+    qint64 m_next_deadline_ns = 0;
+    bool m_screen_tracked = false;
+
+    AircraftData m_latest {};
+    MotionPredictor m_predictor;
+    bool m_showing_prediction = false; // the last frame was a prediction
+    int m_pending_frames = 0;
+    int m_idle_ticks = 0;
+
+    quint64 m_sim_frames = 0;
+    quint64 m_displayed_frames = 0;
+    quint64 m_predicted_frames = 0;
+    int m_last_frames_per_display = 0;
+    int m_max_frames_per_display = 0;
+    qint64 m_last_log_ns = 0;
+};
+
+#endif // FRAMESCHEDULER_H
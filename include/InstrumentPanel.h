@@ -0,0 +1,51 @@
+#ifndef INSTRUMENTPANEL_H
+#define INSTRUMENTPANEL_H
+
+#include <QImage>
+#include <QRegion>
+#include <QVector>
+#include <QWidget>
+
+class InstrumentWidget;
+
+// How the instruments get onto the screen.
+enum class InstrumentRenderMode {
+    Widgets,   // every instrument paints itself
+    Composite, // one InstrumentPanel draws all instruments in a single pass
+    Threaded,  // every instrument rasterizes on the thread pool, paintEvent only blits
+};
+
+// Transparent overlay covering its parent that draws every registered
+// instrument into one backing image, reusing InstrumentWidget's drawing
+// code. Instruments redirect their invalidations here; a repaint re-renders
+// only the dirty parts of the image with one painter and flushes the union
+// of the dirty rects, instead of one painter and flush region per
+// instrument. The instrument widgets stay in their layouts for geometry.
+class InstrumentPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit InstrumentPanel(QWidget *parent);
+    ~InstrumentPanel() override;
+
+    void addInstrument(InstrumentWidget *instrument);
+
+    // rect is in the instrument's coordinates
+    void invalidate(InstrumentWidget *instrument, const QRect &rect);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QRect instrumentRect(const InstrumentWidget *instrument) const;
+    void invalidateAll();
+    void composeDirtyRegion();
+
+    QVector<InstrumentWidget *> m_instruments;
+    QImage m_buffer;
+    QRegion m_dirty;
+};
+
+#endif // INSTRUMENTPANEL_H
@@ -0,0 +1,143 @@
+#ifndef INSTRUMENTWIDGET_H
+#define INSTRUMENTWIDGET_H
+
+#include <QWidget>
+#include <QImage>
+#include <QPainter>
+#include <QSemaphore>
+#include <QtMath>
+#include <functional>
+#include "Metrics.h"
+
+class InstrumentPanel;
+
+// Base class for round instruments drawn in a square logical coordinate
+// system centred on the widget. Each instrument is split into:
+//   - a static background layer (bezel, tick marks, labels)
+//   - a per-frame dynamic layer (horizon, needles, readouts)
+//   - an optional static foreground layer (fixed symbols on top)
+// Static layers are cached in device-pixel-ratio aware images and only
+// re-rendered when the widget size or device pixel ratio changes.
+// Setters in subclasses ignore changes below a configurable threshold and
+// invalidate only the part of the dial that actually changes.
+//
+// Drawing always works on a frame snapshot: captureFrame() copies the
+// geometry and, through captureRenderState(), the subclass state the
+// drawing hooks read. The frame can then be rendered on the GUI thread (own
+// paintEvent or InstrumentPanel) or, in threaded mode, into a back buffer on
+// the thread pool while the setters keep updating the live state. The
+// caches are QImages so that rendering off the GUI thread is allowed.
+class InstrumentWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit InstrumentWidget(qreal logicalSize, QWidget *parent = nullptr);
+    ~InstrumentWidget() override;
+
+    // Smallest value change, in the instrument's units, that triggers a repaint.
+    void setChangeThreshold(float threshold);
+    float changeThreshold() const { return m_change_threshold; }
+
+    // Number of setter calls that did not lead to any repaint.
+    quint64 suppressedRepaints() const { return m_suppressed_repaints; }
+
+    // Publish time of the telemetry snapshot about to be applied through the
+    // setters. If it leads to a repaint, the slot-to-paint latency is recorded
+    // when that frame reaches the screen.
+    void setDataTimestamp(qint64 publishedNs) { m_pending_published_ns = publishedNs; }
+
+    // Captures the current state and draws it with the painter's origin at
+    // the widget's top left corner. GUI thread only.
+    void renderFrame(QPainter &painter);
+
+    // In composite mode the panel draws the instrument and receives its
+    // invalidations; the widget itself only provides geometry.
+    void setPanel(InstrumentPanel *panel);
+    InstrumentPanel *panel() const { return m_panel; }
+
+    // In threaded mode frames are rasterized on the global thread pool into
+    // a back buffer; paintEvent only blits the last finished frame.
+    void setThreadedRendering(bool threaded);
+    bool threadedRendering() const { return m_threaded; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+    // All drawing hooks receive a painter already mapped to logical
+    // coordinates. They may run on a worker thread and must only read the
+    // state copied by captureRenderState().
+    virtual void drawStaticBackground(QPainter &painter) = 0;
+    virtual void drawDynamicLayer(QPainter &painter) = 0;
+    virtual void drawStaticForeground(QPainter &painter);
+    virtual bool hasStaticForeground() const;
+
+    // Called after the static layers were rebuilt, so subclasses can refresh
+    // their own size dependent caches.
+    virtual void staticLayersRebuilt();
+
+    // Copies the state written by the setters into the state read by the
+    // drawing hooks. Called on the GUI thread, never while a frame renders.
+    virtual void captureRenderState();
+
+    // Renders a transparent, logical-size layer at the frame's scale.
+    QImage renderLayer(const std::function<void(QPainter &)> &draw) const;
+
+    void invalidateStaticLayers();
+    // Schedules a repaint of a rectangle given in logical coordinates.
+    void updateLogicalRect(const QRectF &rect);
+    // Schedules a repaint of the whole instrument.
+    void updateInstrument();
+    void countSuppressedRepaint() { ++m_suppressed_repaints; }
+    bool exceedsThreshold(float from, float to) const;
+    // Maps logical coordinates to the widget, for the frame being drawn.
+    void applyLogicalTransform(QPainter &painter) const;
+    // Maps logical coordinates to the widget at its current size.
+    QTransform logicalTransform() const;
+
+    // Pixels per logical unit of the frame being drawn, including the
+    // device pixel ratio.
+    qreal deviceScale() const;
+    qreal logicalSize() const { return m_logical_size; }
+
+private:
+    void captureFrame();
+    void renderInstrument(QPainter &painter);
+    void frameShown(qint64 publishedNs);
+    bool staticLayersValid() const;
+    void rebuildStaticLayers();
+    void scheduleRepaint(const QRect &rect);
+    void startThreadedRender();
+    void threadedRenderFinished();
+
+    qreal m_logical_size;
+    QImage m_background_layer;
+    QImage m_foreground_layer;
+    bool m_static_layers_dirty = true;
+    float m_change_threshold = 0.0f;
+    quint64 m_suppressed_repaints = 0;
+    qint64 m_pending_published_ns = 0;
+    qint64 m_shown_published_ns = 0;
+    Metrics::InstrumentPaint *m_paint_metrics = nullptr;
+    InstrumentPanel *m_panel = nullptr;
+
+    // Frame snapshot, owned by whichever thread renders
+    int m_frame_width = 0;
+    int m_frame_height = 0;
+    qreal m_frame_dpr = 1.0;
+    bool m_frame_static_dirty = true;
+    qint64 m_frame_published_ns = 0;
+
+    // Threaded mode: the worker draws into m_back_buffer, the GUI thread
+    // swaps it with m_front_buffer once the frame is finished.
+    bool m_threaded = false;
+    bool m_render_in_flight = false;
+    bool m_render_requested = false;
+    QImage m_front_buffer;
+    QImage m_back_buffer;
+    qint64 m_front_published_ns = 0;
+    QSemaphore m_render_idle { 1 };
+};
+
+#endif // INSTRUMENTWIDGET_H
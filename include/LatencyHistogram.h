@@ -0,0 +1,54 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Lock-free log-linear (HDR style) histogram of durations in nanoseconds.
+// Values are bucketed with 32 linear sub-buckets per power of two, which
+// keeps the relative error of reported percentiles below about 3% from
+// nanoseconds up to minutes. record() is wait-free and may be called from
+// any number of threads; readers see a consistent-enough view for display.
+class LatencyHistogram
+{
+public:
+    struct Summary {
+        std::uint64_t count = 0;
+        std::int64_t p50 = 0;
+        std::int64_t p99 = 0;
+        std::int64_t max = 0;
+        double mean = 0.0;
+    };
+
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(std::int64_t nanoseconds);
+    Summary summary() const;
+    void reset();
+
+    // Monotonic clock shared by everything that stamps latency samples
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static constexpr int SubBucketBits = 5;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int MaxBits = 42; // ~73 minutes
+    static constexpr int BucketCount = 2 * SubBucketCount + (MaxBits - SubBucketBits - 1) * SubBucketCount;
+
+    static int bucketIndex(std::uint64_t value);
+    static std::int64_t bucketMidpoint(int index);
+
+    std::atomic<std::uint64_t> m_buckets[BucketCount];
+    std::atomic<std::uint64_t> m_count { 0 };
+    std::atomic<std::uint64_t> m_sum { 0 };
+    std::atomic<std::int64_t> m_max { 0 };
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,28 @@
+#ifndef LATENCYOVERLAY_H
+#define LATENCYOVERLAY_H
+
+#include <QTimer>
+#include <QWidget>
+
+// Small translucent panel showing the live LatencyStats report in the top
+// left corner of its parent. Only refreshes while visible.
+class LatencyOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyOverlay(QWidget *parent);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refresh();
+
+    QTimer m_timer;
+    QString m_text;
+};
+
+#endif // LATENCYOVERLAY_H
@@ -0,0 +1,32 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QString>
+#include "LatencyHistogram.h"
+
+// End-to-end telemetry latency, shared by the sources and the instruments:
+//   receiveToSlot  packet arrival to snapshot published for the UI thread
+//   slotToPaint    snapshot published to the end of the paintEvent showing it
+//   paintDuration  time spent in each instrument paintEvent
+//   commandAck     client event sent to the SimVar change confirming it
+class LatencyStats
+{
+public:
+    static LatencyStats &instance();
+
+    LatencyHistogram receiveToSlot;
+    LatencyHistogram slotToPaint;
+    LatencyHistogram paintDuration;
+    LatencyHistogram commandAck;
+
+    // One line per histogram with count, p50, p99 and max in milliseconds
+    QString report() const;
+    // Appends a timestamped report to the file; returns false if it cannot be written
+    bool dumpToFile(const QString &path) const;
+    void reset();
+
+private:
+    LatencyStats() = default;
+};
+
+#endif // LATENCYSTATS_H
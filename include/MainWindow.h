@@ -2,11 +2,22 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QPushButton>
+#include <QTimer>
+#include <array>
 
-#include "SimConnectClient.h"
+#include "TelemetrySource.h"
+#include "AlertEngine.h"
+#include "FrameScheduler.h"
 #include "AttitudeIndicator.h"
 #include "Compass.h"
 #include "RpmIndicator.h"
+#include "TrafficDisplay.h"
+#include "TrafficStore.h"
+#include "InstrumentPanel.h"
+
+class CommandPipeline;
+class LatencyOverlay;
 
 namespace Ui {
     class MainWindow;
@@ -17,16 +28,26 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    // Takes ownership of the telemetry source
+    explicit MainWindow(TelemetrySource *telemetrySource, QWidget *parent = nullptr);
     ~MainWindow();
 
+    void setRenderMode(InstrumentRenderMode mode);
+    // How far past the newest sim frame the instruments are extrapolated
+    void setPredictionHorizon(qint64 horizonNs) { m_frameScheduler->setPredictionHorizon(horizonNs); }
+    // Adds user alert rules to the built-in ones, replacing rules of the same name
+    bool loadAlertRules(const QString &path);
+
 private slots:
     void onConnectClicked();
     void onSimConnected();
     void onSimDisconnected();
-    void onAircraftDataUpdated(const AircraftData &data);
+    void onAircraftDataUpdated(const AircraftData &data, const AircraftData &display);
+    void onTrafficUpdated(const TrafficBatch &batch);
     void on_actionsource_code_triggered();
-    void onGearButtonToggled(bool checked);
+    void on_actionlatency_overlay_toggled(bool checked);
+    void on_actiondump_latency_triggered();
+    void on_actiontrace_recording_toggled(bool checked);
     void on_gearButton_clicked(bool checked);
     void on_parkingBrakeButton_clicked(bool checked);
     void on_fdButton_clicked(bool checked);
@@ -45,9 +66,43 @@ private slots:
 
 private:
     void updateControlsState(bool isConnected);
+    void setInstrumentDataTimestamp(qint64 publishedNs);
+    void evaluateAlerts(const AircraftData &data, std::uint64_t changed);
+    void updateAlertMessage();
+    void setEngineRunning(int engine, bool running);
 
-    SimConnectClient *m_simConnectClient;
+    // Values as currently shown by the widgets, at display precision.
+    // onAircraftDataUpdated only touches a widget when its entry changes.
+    struct DisplayState {
+        long long gear_total_tenths = -1;
+        long long gear_center_pct = -1;
+        long long gear_left_pct = -1;
+        long long gear_right_pct = -1;
+        int gear_handle_down = -1;
+    };
+
+    TelemetrySource *m_telemetrySource;
+    FrameScheduler *m_frameScheduler;
+    CommandPipeline *m_commandPipeline;
     Ui::MainWindow *ui;
-    AircraftData m_currentAircraftData;
+    AircraftData m_currentAircraftData {};
+    // Frame the animated instruments were last given, possibly predicted
+    AircraftData m_displayedAircraftData {};
+    bool m_hasAircraftData = false;
+    DisplayState m_displayState;
+    LatencyOverlay *m_latencyOverlay;
+    InstrumentPanel *m_instrumentPanel = nullptr;
+    AlertEngine m_alertEngine;
+    // Fires the next debounce deadline when no new telemetry arrives
+    QTimer m_alertTimer;
+    // Rules driving the engine start/stop buttons, -1 if not defined
+    std::array<int, 4> m_engineRunningRules = { -1, -1, -1, -1 };
+    TrafficStore m_trafficStore;
+    std::vector<TrafficStore::Contact> m_trafficContacts;
+
+    std::array<RpmIndicator *, 4> m_rpmIndicators;
+    std::array<QPushButton *, 4> m_engineButtons;
+    std::array<QString, 4> m_engineStartTexts;
+    std::array<QString, 4> m_engineStopTexts;
 };
 #endif // MAINWINDOW_H 
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// Process-wide counters and gauges exposed in Prometheus text format by
+// MetricsServer. Updates are relaxed atomic increments and may come from
+// any thread, so they stay enabled whether or not anyone scrapes them.
+class Metrics
+{
+public:
+    static constexpr int MaxSimConnectMessageTypes = 128;
+    static constexpr int MaxEventIds = 64;
+
+    struct InstrumentPaint {
+        QByteArray name;
+        std::atomic<std::uint64_t> count { 0 };
+        std::atomic<std::uint64_t> durationNs { 0 };
+    };
+
+    static Metrics &instance();
+
+    // SIMCONNECT_RECV_ID of every message seen by dispatchProc; the client
+    // registers names for the IDs it knows.
+    void countSimConnectMessage(unsigned id);
+    void setSimConnectMessageName(unsigned id, const char *name);
+
+    void countEventTransmitted(int eventId) { count(m_events_transmitted, eventId, MaxEventIds); }
+    void countEventFailed(int eventId) { count(m_events_failed, eventId, MaxEventIds); }
+
+    // Stable per-instrument entry; look it up once and keep the reference
+    InstrumentPaint &instrumentPaint(const QByteArray &name);
+
+    void setConnected(bool connected);
+
+    std::atomic<std::uint64_t> simFrames { 0 };
+    std::atomic<std::uint64_t> displayedFrames { 0 };
+    std::atomic<std::uint64_t> coalescedFrames { 0 };
+    std::atomic<std::uint64_t> predictedFrames { 0 };
+
+    // CommandPipeline
+    std::atomic<std::uint64_t> commandsSubmitted { 0 };
+    std::atomic<std::uint64_t> commandsCoalesced { 0 };
+    std::atomic<std::uint64_t> commandsRateLimited { 0 };
+    std::atomic<std::uint64_t> commandsAcknowledged { 0 };
+    std::atomic<std::uint64_t> commandsTimedOut { 0 };
+
+    // TelemetryServer
+    std::atomic<std::uint64_t> telemetryClients { 0 };
+    std::atomic<std::uint64_t> telemetryFramesSent { 0 };
+    std::atomic<std::uint64_t> telemetryFramesDropped { 0 };
+    std::atomic<std::uint64_t> telemetryBytesSent { 0 };
+
+    // Traffic
+    std::atomic<std::uint64_t> trafficObjects { 0 };
+
+    QByteArray prometheusText() const;
+
+private:
+    Metrics() = default;
+
+    static void count(std::atomic<std::uint64_t> *counters, int index, int size)
+    {
+        if (index >= 0 && index < size) {
+            counters[index].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint64_t> m_simconnect_messages[MaxSimConnectMessageTypes] = {};
+    std::atomic<const char *> m_simconnect_message_names[MaxSimConnectMessageTypes] = {};
+    std::atomic<std::uint64_t> m_events_transmitted[MaxEventIds] = {};
+    std::atomic<std::uint64_t> m_events_failed[MaxEventIds] = {};
+
+    mutable std::mutex m_instruments_mutex;
+    std::deque<InstrumentPaint> m_instruments;
+
+    std::atomic<bool> m_connected { false };
+    std::atomic<std::uint64_t> m_connects { 0 };
+    std::atomic<std::uint64_t> m_disconnects { 0 };
+};
+
+#endif // METRICS_H
@@ -0,0 +1,26 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <QTcpServer>
+
+// Minimal HTTP endpoint serving Metrics in Prometheus text format at
+// GET /metrics. One request per connection; anything else gets a 404.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+
+    bool listen(const QHostAddress &address, quint16 port);
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+
+    QTcpServer m_server;
+};
+
+#endif // METRICSSERVER_H
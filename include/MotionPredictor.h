@@ -0,0 +1,79 @@
+#ifndef MOTIONPREDICTOR_H
+#define MOTIONPREDICTOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "AircraftData.h"
+
+// Predicts the animated instrument channels (roll, pitch, heading and N1)
+// for the time a frame reaches the screen. Sim frames arrive unevenly, so
+// showing the newest sample as is makes the instruments stutter and lag.
+//
+// The last sample and the slope towards it are kept per channel in
+// structure-of-arrays form and evaluated as one batch. Display times before
+// the newest sample interpolate towards it, later ones extrapolate along the
+// slope until the next sample is due (ExtrapolationIntervals, at most the
+// horizon). A feed of changed-only data goes quiet when nothing changes, so
+// once the next sample is overdue the prediction eases back to the newest
+// sample over one interval and then holds it. Heading slopes are taken on
+// the shortest way round the circle and results are wrapped to [0, 360).
+// Timestamps are AircraftData::received_ns (LatencyHistogram::now()).
+class MotionPredictor
+{
+public:
+    enum Channel {
+        Roll,
+        Pitch,
+        Heading,
+        EngineN1_1,
+        EngineN1_2,
+        EngineN1_3,
+        EngineN1_4,
+        ChannelCount
+    };
+
+    explicit MotionPredictor(std::int64_t horizonNs = 100000000);
+
+    // Longest time past the newest sample that is extrapolated; 0 disables
+    // prediction entirely.
+    void setHorizon(std::int64_t horizonNs) { m_horizon_ns = horizonNs > 0 ? horizonNs : 0; }
+    std::int64_t horizon() const { return m_horizon_ns; }
+
+    void reset();
+    void addSample(const AircraftData &data);
+    bool hasSample() const { return m_sample_count > 0; }
+
+    // True while a prediction for displayTimeNs still moves, i.e. there is
+    // a slope and the time lies before the prediction is back at the newest
+    // sample.
+    bool isActive(std::int64_t displayTimeNs) const;
+
+    // Newest sample with the animated channels predicted for displayTimeNs.
+    AircraftData predict(std::int64_t displayTimeNs) const;
+    // Batch form of predict() over the channels only.
+    void predictChannels(std::int64_t displayTimeNs, float *values) const;
+
+private:
+    // Sample spacing above which the slope is discarded (e.g. after a
+    // scenery load stall) instead of being trusted.
+    static constexpr std::int64_t MaxSampleGapNs = 250000000;
+    // Extrapolation past the newest sample, in sample intervals; the slack
+    // above one covers arrival jitter of a live feed.
+    static constexpr double ExtrapolationIntervals = 1.5;
+
+    double extrapolationLimitNs() const;
+
+    AircraftData m_latest {};
+    std::int64_t m_latest_ns = 0;
+    // Low-pass filtered sample interval, which keeps arrival jitter out of
+    // the slopes
+    double m_interval_ns = 0.0;
+    int m_sample_count = 0;
+    std::int64_t m_horizon_ns;
+
+    alignas(16) std::array<float, ChannelCount> m_values {};
+    alignas(16) std::array<float, ChannelCount> m_slopes {}; // units per second
+};
+
+#endif // MOTIONPREDICTOR_H
@@ -0,0 +1,62 @@
+#ifndef READOUTRENDERER_H
+#define READOUTRENDERER_H
+
+#include <QPainter>
+#include <QImage>
+#include <QFont>
+#include <QColor>
+#include <array>
+
+// Draws short numeric readouts from a pre-rasterized glyph atlas.
+// The atlas is rebuilt together with an instrument's static layers; per frame
+// the renderer only blits glyph cells, so no text layout, shaping or string
+// allocation happens on the paint path. Text is passed as plain char buffers,
+// typically produced by formatFixed().
+class ReadoutRenderer
+{
+public:
+    ReadoutRenderer(const QFont &font, const QColor &color);
+
+    // Rasterizes the glyph atlas for the given pixels-per-logical-unit scale.
+    void rebuild(qreal deviceScale);
+    bool isValid() const { return !m_atlas.isNull(); }
+
+    qreal textWidth(const char *text, int length) const;
+
+    // Draws text aligned inside a logical rectangle, like QPainter::drawText.
+    void draw(QPainter &painter, const QRectF &rect, Qt::Alignment alignment, const char *text, int length) const;
+    // Draws text starting at a baseline position, like QPainter::drawText(QPointF, ...).
+    void draw(QPainter &painter, const QPointF &baseline, const char *text, int length) const;
+
+    // Fixed-point formatting without allocation. Writes at most capacity - 1
+    // characters plus a terminator and returns the number of characters.
+    // zeroPadWidth behaves like the width of printf's "%0*.*f".
+    static int formatFixed(char *buffer, int capacity, double value, int decimals, int zeroPadWidth = 0);
+    // Appends a literal to a buffer filled by formatFixed and returns the new length.
+    static int appendText(char *buffer, int length, int capacity, const char *text);
+
+private:
+    static constexpr const char *glyphSet = "0123456789.-+%:T ";
+
+    int glyphIndex(char c) const
+    {
+        unsigned char code = static_cast<unsigned char>(c);
+        return code < m_glyph_index.size() ? m_glyph_index[code] : -1;
+    }
+    void drawGlyphs(QPainter &painter, qreal x, qreal baseline, const char *text, int length) const;
+
+    QFont m_font;
+    QColor m_color;
+    QImage m_atlas;
+    std::array<qint8, 128> m_glyph_index;
+    std::array<qreal, 32> m_advance {};
+    qreal m_ascent = 0.0;
+    qreal m_descent = 0.0;
+    qreal m_padding = 1.0;
+    qreal m_cell_width = 0.0;
+    qreal m_cell_height = 0.0;
+    int m_cell_pixel_width = 0;
+    int m_cell_pixel_height = 0;
+};
+
+#endif // READOUTRENDERER_H
@@ -0,0 +1,84 @@
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <cstdint>
+#include <vector>
+#include "TelemetrySource.h"
+#include "FlightDataFormat.h"
+
+// Telemetry source that plays back a recorded .fdr flight through the same
+// aircraftDataUpdated signal the live backends use. Samples are emitted at
+// their recorded spacing, scaled by the playback speed. Seeking uses the
+// chunk index (binary search over chunks, then within the decoded chunk);
+// files without an index, e.g. from an interrupted recording, get one built
+// from the chunk headers when opened.
+//
+// Timestamps are microseconds since the start of the recording.
+class ReplaySource : public TelemetrySource
+{
+    Q_OBJECT
+
+public:
+    explicit ReplaySource(QObject *parent = nullptr);
+
+    bool open(const QString &path);
+
+    bool isConnected() const override;
+    bool isPaused() const { return m_paused; }
+    double speed() const { return m_speed; }
+    qint64 duration() const;
+    qint64 position() const;
+    void setStartPosition(qint64 timestamp) { m_start_position = timestamp; }
+
+public slots:
+    void connectToSim() override;
+    void disconnectFromSim() override;
+    void transmitEvent(EVENT_ID eventId, quint32 data = 0) override;
+
+    void setSpeed(double speed);
+    void setPaused(bool paused);
+    void togglePause() { setPaused(!m_paused); }
+    // Pauses playback and emits the next recorded sample
+    void stepFrame();
+    void seek(qint64 timestamp);
+
+private slots:
+    void playDue();
+
+private:
+    bool buildIndexFromChunks(std::size_t offset);
+    bool loadChunk(std::size_t chunk);
+    bool atEnd() const;
+    qint64 cursorTimestamp() const { return m_timestamps[m_sample]; }
+    void emitCursorSample();
+    void restartClock(qint64 mediaTime);
+    qint64 mediaTime() const;
+    void scheduleNext();
+
+    QFile m_file;
+    const std::uint8_t *m_data = nullptr;
+    std::size_t m_size = 0;
+    FlightData::FileHeader m_header;
+    std::vector<FlightData::IndexEntry> m_index;
+    // File column for each AircraftData channel, -1 if not recorded
+    std::vector<int> m_channel_map;
+
+    // Decoded current chunk and the cursor (next sample to emit)
+    std::size_t m_chunk = SIZE_MAX;
+    std::vector<std::int64_t> m_timestamps;
+    std::vector<double> m_values;
+    std::size_t m_sample = 0;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_anchor_media_time = 0;
+    qint64 m_start_position = 0;
+    double m_speed = 1.0;
+    bool m_paused = false;
+    bool m_connected = false;
+};
+
+#endif // REPLAYSOURCE_H
@@ -1,10 +1,10 @@
 #ifndef RPMINDICATOR_H
 #define RPMINDICATOR_H
 
-#include <QWidget>
-#include <QPainter>
+#include "InstrumentWidget.h"
+#include "ReadoutRenderer.h"
 
-class RpmIndicator : public QWidget
+class RpmIndicator : public InstrumentWidget
 {
     Q_OBJECT
 
@@ -17,12 +17,23 @@ public slots:
     void setThrottlePercent(float throttle);
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
+    void drawStaticBackground(QPainter &painter) override;
+    void drawDynamicLayer(QPainter &painter) override;
+    void staticLayersRebuilt() override;
+    void captureRenderState() override;
 
 private:
     float m_rpm_percent = 0.0f;
     float m_throttle_percent = 0.0f;
+    float m_arc_rpm_percent = 0.0f; // value the arc was last invalidated for
     QString m_title;
+    // Values of the frame being drawn
+    float m_render_rpm_percent = 0.0f;
+    float m_render_throttle_percent = 0.0f;
+    float m_render_arc_rpm_percent = 0.0f;
+    QString m_render_title;
+    ReadoutRenderer m_rpm_readout;
+    ReadoutRenderer m_throttle_readout;
 };
 
-#endif // RPMINDICATOR_H 
\ No newline at end of file
+#endif // RPMINDICATOR_H
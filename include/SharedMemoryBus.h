@@ -0,0 +1,36 @@
+#ifndef SHAREDMEMORYBUS_H
+#define SHAREDMEMORYBUS_H
+
+#include <QObject>
+#include <QString>
+#include "AircraftData.h"
+#include "msfs_telemetry_shm.h"
+
+// Publishes every decoded snapshot into the named shared-memory region
+// described by shm/msfs_telemetry_shm.h, so local tools (overlays, loggers,
+// motion platforms) can read the dashboard's telemetry with the bundled C
+// reader instead of opening their own SimConnect connection.
+//
+// Writing is a few stores and two memcpy into mapped memory; it is meant to
+// be called directly on the thread that decodes the data. Only one thread
+// may publish at a time.
+class SharedMemoryBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SharedMemoryBus(QObject *parent = nullptr);
+    ~SharedMemoryBus() override;
+
+    bool open(const QString &name);
+    void close();
+    bool isOpen() const { return m_mapping.shm != nullptr; }
+
+public slots:
+    void publish(const AircraftData &data);
+
+private:
+    msfs_telemetry_mapping m_mapping {};
+};
+
+#endif // SHAREDMEMORYBUS_H
@@ -2,104 +2,87 @@
 #define SIMCONNECTCLIENT_H
 
 #include <QObject>
-#include <QTimer>
+#include <QThread>
+#include <atomic>
+#include <mutex>
 #include <windows.h>
 #include "SimConnect.h"
+#include "SimVarRegistry.h"
+#include "SnapshotSlot.h"
+#include "TelemetrySource.h"
 
-// Data structure to hold aircraft data received from SimConnect
-struct AircraftData {
-    double gear_total_extended_pct;
-    double parking_brake_position;
-    double autopilot_master;
-    double attitude_bank_radians;
-    double attitude_pitch_radians;
-    double gear_handle_position;
-    double plane_heading_degrees_true;
-    double gear_damage_by_speed;
-    double gear_warning_center;
-    double gear_warning_left;
-    double gear_warning_right;
-    double gear_pos_center;
-    double gear_pos_left;
-    double gear_pos_right;
-    double eng_n1_1;
-    double eng_n1_2;
-    double eng_n1_3;
-    double eng_n1_4;
-    double throttle_1;
-    double throttle_2;
-    double throttle_3;
-    double throttle_4;
-};
-
-class SimConnectClient : public QObject
+// Telemetry source backed by a live SimConnect connection to MSFS
+class SimConnectClient : public TelemetrySource
 {
     Q_OBJECT
 
 public:
-    enum EVENT_ID
-    {
-        EVENT_TOGGLE_FLIGHT_DIRECTOR,
-        EVENT_AP_MASTER,
-        EVENT_TOGGLE_NAV_GPS,
-        EVENT_AP_NAV1_HOLD,
-        EVENT_AP_APR_HOLD,
-        EVENT_AP_BC_HOLD,
-        EVENT_AP_WING_LEVELER,
-        EVENT_AP_ALT_HOLD,
-        EVENT_AP_VS_HOLD,
-        EVENT_AP_FLC_HOLD,
-        EVENT_HEADING_BUG_SET,
-        EVENT_AP_SPD_VAR_SET,
-        EVENT_AP_ALT_VAR_SET,
-        EVENT_AP_VS_VAR_SET,
-        EVENT_AUTO_THROTTLE_ARM,
-        EVENT_TOGGLE_ENGINE1_STARTER,
-        EVENT_TOGGLE_ENGINE2_STARTER,
-        EVENT_TOGGLE_ENGINE3_STARTER,
-        EVENT_TOGGLE_ENGINE4_STARTER,
-        EVENT_ENGINE_AUTO_SHUTDOWN,
-        EVENT_GEAR_UP,
-        EVENT_GEAR_DOWN,
-        EVENT_FLAPS_UP,
-        EVENT_FLAPS_DOWN,
-        EVENT_PARKING_BRAKES,
-        EVENT_SPOILERS_ARM
-    };
-
     explicit SimConnectClient(QObject *parent = nullptr);
     ~SimConnectClient();
 
-    bool isConnected() const;
-
-public slots:
-    void connectToSim();
-    void disconnectFromSim();
-    void transmitEvent(EVENT_ID eventId, DWORD data = 0);
+    bool isConnected() const override;
 
-signals:
-    void connected();
-    void disconnected();
-    void aircraftDataUpdated(const AircraftData &data);
+    // Lock-free read of the most recent snapshot; callable from any thread.
+    bool latestAircraftData(AircraftData &data) const;
 
-private slots:
-    void processSimConnectEvents();
+public slots:
+    void connectToSim() override;
+    void disconnectFromSim() override;
+    void transmitEvent(EVENT_ID eventId, quint32 data = 0) override;
 
 private:
     static void CALLBACK dispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
+    void registerSimVars();
     void setupDataRequests();
     void setupEvents();
+    void startDispatchThread();
+    void stopDispatchThread();
+    void dispatchLoop();
+    void publishAircraftData(const AircraftData &state, std::int64_t receivedNs);
+    void requestTrafficSweep(std::int64_t nowNs);
+    void receiveTrafficEntry(const SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE *entry, DWORD cbData);
+    void deliverLatestAircraftData();
 
     HANDLE hSimConnect = nullptr;
-    QTimer* processTimer;
+    // Signalled by SimConnect whenever messages are waiting
+    HANDLE hSimConnectEvent = nullptr;
+
+    // SimConnect messages are dispatched on this thread, blocking on
+    // hSimConnectEvent, so intake does not depend on GUI thread load.
+    QThread *m_dispatchThread = nullptr;
+    std::atomic<bool> m_dispatchRunning { false };
+    // Serializes SimConnect API calls between the dispatch, GUI and command
+    // threads, and guards hSimConnect while it is closed
+    std::mutex m_simConnectMutex;
+
+    // Latest snapshot, handed to the GUI thread without locking. At most one
+    // notification is queued at a time; the GUI always reads the newest value.
+    SnapshotSlot<AircraftData> m_latestData;
+    std::atomic<bool> m_notifyPending { false };
+
+    // Subscribed SimVars and the state assembled from changed-only updates;
+    // only touched by the dispatch thread while connected.
+    SimVarRegistry m_simVars;
+
+    // Traffic around the own ship, polled with RequestDataOnSimObjectType.
+    // A sweep returns one message per aircraft in range; the batch is
+    // assembled on the dispatch thread and emitted once the last one arrived.
+    TrafficBatch m_trafficBatch;
+    bool m_trafficSweepPending = false;
+    std::int64_t m_nextTrafficSweepNs = 0;
+    // The user aircraft is part of every sweep and reported as own ship instead
+    DWORD m_ownshipObjectId = SIMCONNECT_OBJECT_ID_USER;
 
-    enum class DEFINITION_ID {
-        AIRCRAFT_DATA,
-    };
+    // SimVar request groups use consecutive definition and request IDs
+    // starting here, one per group in the registry.
+    static constexpr DWORD SIMVAR_GROUP_ID_BASE = 1;
+    static SIMCONNECT_DATA_DEFINITION_ID groupDefinitionId(int group) { return SIMVAR_GROUP_ID_BASE + group; }
+    static SIMCONNECT_DATA_REQUEST_ID groupRequestId(int group) { return SIMVAR_GROUP_ID_BASE + group; }
 
-    enum class REQUEST_ID {
-        AIRCRAFT_DATA,
-    };
+    // Traffic IDs, well clear of the SimVar groups
+    static constexpr SIMCONNECT_DATA_DEFINITION_ID TRAFFIC_DEFINITION_ID = 100;
+    static constexpr SIMCONNECT_DATA_REQUEST_ID TRAFFIC_REQUEST_ID = 100;
+    static constexpr SIMCONNECT_DATA_REQUEST_ID TRAFFIC_OWNSHIP_REQUEST_ID = 101;
 };
 
 #endif // SIMCONNECTCLIENT_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef SIMVARREGISTRY_H
+#define SIMVARREGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AircraftData.h"
+
+// Runtime table of the SimVars the dashboard subscribes to. Each variable
+// has a datum ID (its index) used to tag it on the wire, and maps onto one
+// field of a persistent AircraftData state. Variables are split into request
+// groups, each requested with its own definition, request ID, period and
+// interval, so slow-moving state does not ride along with every sim frame.
+// All groups decode into the same state table. Data is requested with
+// SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | SIMCONNECT_DATA_REQUEST_FLAG_TAGGED,
+// so SimConnect only sends the variables that moved by more than their
+// epsilon, as (datum ID, value) pairs, and nothing at all when none did.
+//
+// Not thread safe: decoding runs on the thread that dispatches SimConnect
+// messages.
+class SimVarRegistry
+{
+public:
+    enum class Period {
+        VisualFrame,
+        SimFrame,
+        Second,
+    };
+
+    enum class DataType {
+        Float32,
+        Int32,
+    };
+
+    struct Group {
+        const char *name;
+        Period period;
+        // Number of periods to skip between updates (0 = every period)
+        std::uint32_t interval;
+        std::uint64_t messages = 0;
+        std::uint64_t values = 0;
+    };
+
+    struct Variable {
+        int group;
+        const char *name;
+        const char *unit;
+        DataType type;
+        // Byte offset of the 4 byte target field in AircraftData
+        std::size_t offset;
+        float epsilon;
+    };
+
+    // Returns the group index, which doubles as its definition and request ID.
+    int addGroup(const char *name, Period period, std::uint32_t interval = 0);
+    const std::vector<Group> &groups() const { return m_groups; }
+
+    // Returns the datum ID of the new variable.
+    int add(int group, const char *name, const char *unit, DataType type, std::size_t offset, float epsilon = 0.0f);
+    // Registers every field of the AircraftData schema; groupIds maps each
+    // SimVarGroup to a group added with addGroup().
+    void addAircraftSchema(const int (&groupIds)[2]);
+    const std::vector<Variable> &variables() const { return m_variables; }
+
+    // Decodes a tagged payload of count (DWORD datum ID, 4 byte value) pairs
+    // received for a group into the state table. Returns the number of
+    // variables that changed.
+    int applyTagged(int group, const std::uint8_t *data, std::size_t size, std::uint32_t count);
+
+    const AircraftData &state() const { return m_state; }
+    void resetState();
+
+    std::uint64_t messagesDecoded() const { return m_messages; }
+    std::uint64_t valuesDecoded() const { return m_values; }
+
+private:
+    std::vector<Group> m_groups;
+    std::vector<Variable> m_variables;
+    AircraftData m_state {};
+    std::uint64_t m_messages = 0;
+    std::uint64_t m_values = 0;
+};
+
+#endif // SIMVARREGISTRY_H
@@ -0,0 +1,88 @@
+#ifndef SNAPSHOTSLOT_H
+#define SNAPSHOTSLOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-producer, multi-reader "latest value" slot based on a seqlock.
+// The producer never blocks and never waits for readers; readers never take
+// a lock and simply retry if they raced with a write. Intended for handing
+// the most recent telemetry snapshot from an I/O thread to the GUI thread.
+//
+// The payload is stored as relaxed atomic words so concurrent reads are
+// well-defined; T only needs to be trivially copyable.
+template <typename T>
+class SnapshotSlot
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SnapshotSlot requires a trivially copyable type");
+
+public:
+    SnapshotSlot()
+    {
+        for (auto &word : m_words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SnapshotSlot(const SnapshotSlot &) = delete;
+    SnapshotSlot &operator=(const SnapshotSlot &) = delete;
+
+    // Must only be called from one thread at a time.
+    void publish(const T &value)
+    {
+        std::uint64_t words[WordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WordCount; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Copies the latest value into out. Returns false if nothing was published yet.
+    bool load(T &out) const
+    {
+        std::uint64_t ignored = 0;
+        return load(out, ignored);
+    }
+
+    // Same as load(), also returning the version of the copied value.
+    bool load(T &out, std::uint64_t &version) const
+    {
+        std::uint64_t words[WordCount];
+        for (;;) {
+            std::uint64_t before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue; // write in progress
+            }
+            for (std::size_t i = 0; i < WordCount; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&out, words, sizeof(T));
+                version = before / 2;
+                return before != 0;
+            }
+        }
+    }
+
+    // Number of values published so far; cheap way to poll for changes.
+    std::uint64_t version() const
+    {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr std::size_t WordCount = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    alignas(64) std::atomic<std::uint64_t> m_sequence { 0 };
+    alignas(64) std::atomic<std::uint64_t> m_words[WordCount];
+};
+
+#endif // SNAPSHOTSLOT_H
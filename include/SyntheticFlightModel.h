@@ -0,0 +1,37 @@
+#ifndef SYNTHETICFLIGHTMODEL_H
+#define SYNTHETICFLIGHTMODEL_H
+
+#include <cstdint>
+#include "TelemetrySource.h"
+
+// Deterministic flight generator. The same seed, step sizes and event
+// sequence always produce the same AircraftData sequence, independent of
+// wall-clock timing, so runs can be compared and profiled.
+class SyntheticFlightModel
+{
+public:
+    explicit SyntheticFlightModel(std::uint32_t seed = 1);
+
+    void reset(std::uint32_t seed);
+    // Advances the simulation by dt seconds and returns the new state.
+    const AircraftData &step(double dt);
+    void applyEvent(TelemetrySource::EVENT_ID eventId, quint32 data);
+
+    const AircraftData &state() const { return m_data; }
+    double time() const { return m_time; }
+
+private:
+    double noise();
+
+    AircraftData m_data {};
+    double m_time = 0.0;
+    std::uint32_t m_random = 1;
+    bool m_engine_running[4] = { true, true, true, true };
+    bool m_gear_down = true;
+    double m_roll_noise = 0.0;
+    double m_pitch_noise = 0.0;
+    // Integrated in double precision; AircraftData only stores floats
+    double m_heading = 0.0;
+};
+
+#endif // SYNTHETICFLIGHTMODEL_H
@@ -0,0 +1,50 @@
+#ifndef SYNTHETICFLIGHTSOURCE_H
+#define SYNTHETICFLIGHTSOURCE_H
+
+#include <QTimer>
+#include <QElapsedTimer>
+#include "TelemetrySource.h"
+#include "SyntheticFlightModel.h"
+#include "SyntheticTrafficModel.h"
+
+// Telemetry source that plays a deterministic synthetic flight at a fixed
+// sample rate, from 1 Hz up to several kHz. Used to run, profile and stress
+// the dashboard without a simulator.
+class SyntheticFlightSource : public TelemetrySource
+{
+    Q_OBJECT
+
+public:
+    explicit SyntheticFlightSource(double rateHz = 60.0, QObject *parent = nullptr);
+
+    // Number of AI aircraft flying around the own ship (0 disables traffic).
+    void setTrafficCount(int count) { m_traffic_count = qMax(0, count); }
+    int trafficCount() const { return m_traffic_count; }
+
+    bool isConnected() const override;
+    double rate() const { return m_rate_hz; }
+    quint64 samplesGenerated() const { return m_samples; }
+
+public slots:
+    void connectToSim() override;
+    void disconnectFromSim() override;
+    void transmitEvent(EVENT_ID eventId, quint32 data = 0) override;
+
+private slots:
+    void generate();
+
+private:
+    SyntheticFlightModel m_model;
+    SyntheticTrafficModel m_traffic;
+    TrafficBatch m_traffic_batch;
+    int m_traffic_count = 0;
+    double m_traffic_time = 0.0; // model time of the last traffic sweep
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    double m_rate_hz;
+    quint64 m_samples = 0;
+    quint64 m_scheduled = 0; // samples accounted for by the wall clock
+    bool m_connected = false;
+};
+
+#endif // SYNTHETICFLIGHTSOURCE_H
@@ -0,0 +1,38 @@
+#ifndef SYNTHETICTRAFFICMODEL_H
+#define SYNTHETICTRAFFICMODEL_H
+
+#include <cstdint>
+#include <vector>
+#include "TrafficStore.h"
+
+// Deterministic AI traffic around a synthetic own ship. Targets fly straight
+// lines with a climb or descent; a target leaving the radius is replaced by a
+// new one with a fresh object ID, so stores see inserts, updates and
+// evictions just like with live SimConnect traffic.
+class SyntheticTrafficModel
+{
+public:
+    static constexpr double RadiusNm = 40.0;
+
+    explicit SyntheticTrafficModel(int count = 0, std::uint32_t seed = 1);
+
+    void reset(int count, std::uint32_t seed);
+    int count() const { return static_cast<int>(m_ids.size()); }
+
+    // Advances own ship and traffic by dt seconds and fills a complete
+    // sweep. The own ship flies the given track at a fixed speed.
+    void step(double dt, double ownshipTrackDeg, TrafficBatch &batch);
+
+private:
+    double random(double low, double high);
+    void spawn(std::size_t index, double minDistanceNm);
+
+    std::uint32_t m_random = 1;
+    std::uint32_t m_next_id = 1;
+    TrafficSample m_ownship;
+
+    std::vector<std::uint32_t> m_ids;
+    std::vector<TrafficSample> m_targets;
+};
+
+#endif // SYNTHETICTRAFFICMODEL_H
@@ -0,0 +1,106 @@
+#ifndef TELEMETRYPROTOCOL_H
+#define TELEMETRYPROTOCOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AircraftData.h"
+
+// Binary protocol between TelemetryServer and its subscribers, over TCP.
+//
+//   message   u16 length (type + payload), u8 type, payload
+//
+//   Hello     client -> server: magic "MSTP", u16 version, u16 rate (Hz)
+//   SetRate   client -> server: u16 rate (Hz)
+//   Ack       client -> server: u32 sequence of a decoded frame
+//   Welcome   server -> client: u16 version, u16 field count, u32 schema hash
+//   Frame     server -> client: u32 sequence, u32 base sequence, i64 source
+//             time, i64 send time, u32 dropped, u64 changed mask, then one
+//             varint per changed field
+//
+// Sequences have no gaps; snapshots the server skipped for a slow client
+// are counted in the dropped field of the next frame instead.
+//
+// Fields travel quantized: integers as is, floats in multiples of their
+// schema epsilon (the smallest change SimConnect reports). A frame holds the
+// zigzag varint difference to the state of its base frame, which is the
+// newest frame the client acknowledged, or the all-zero state for base 0.
+// Times are LatencyHistogram::now(), so they are only comparable on the
+// same host (e.g. when measuring over loopback). All integers are little
+// endian.
+namespace TelemetryProtocol {
+
+constexpr std::uint32_t Magic = 0x5054534D; // "MSTP"
+constexpr std::uint16_t Version = 2;
+constexpr std::size_t MessageHeaderSize = 3;
+constexpr std::size_t MaxMessageSize = 1024;
+
+// Frames a client may have outstanding without acknowledging them. Clients
+// keep at least this many decoded states to resolve bases.
+constexpr std::uint32_t AckWindow = 64;
+
+enum class MessageType : std::uint8_t {
+    Hello = 1,
+    SetRate = 2,
+    Ack = 3,
+    Welcome = 16,
+    Frame = 17,
+};
+
+using State = std::array<std::int64_t, AircraftSchema::FieldCount>;
+
+struct Hello {
+    std::uint16_t version = Version;
+    std::uint16_t rateHz = 0;
+};
+
+struct Welcome {
+    std::uint16_t version = Version;
+    std::uint16_t fieldCount = 0;
+    std::uint32_t schemaHash = 0;
+};
+
+struct FrameHeader {
+    std::uint32_t sequence = 0;
+    std::uint32_t baseSequence = 0; // 0: relative to the all-zero state
+    std::int64_t sourceNs = 0;      // AircraftData::received_ns of the snapshot
+    std::int64_t sentNs = 0;
+    std::uint32_t dropped = 0;      // snapshots skipped since the previous frame
+};
+
+// A complete message inside a receive buffer.
+struct Message {
+    MessageType type;
+    const std::uint8_t *payload;
+    std::size_t size;
+};
+
+// Hash of the field names, units and order; both ends must agree on it.
+std::uint32_t schemaHash();
+
+void quantize(const AircraftData &data, State &state);
+void dequantize(const State &state, AircraftData &data);
+
+void writeHello(const Hello &hello, std::vector<std::uint8_t> &out);
+void writeSetRate(std::uint16_t rateHz, std::vector<std::uint8_t> &out);
+void writeAck(std::uint32_t sequence, std::vector<std::uint8_t> &out);
+void writeWelcome(const Welcome &welcome, std::vector<std::uint8_t> &out);
+void writeFrame(const FrameHeader &header, const State &base, const State &state, std::vector<std::uint8_t> &out);
+
+// Finds the message at the front of data. Returns the number of bytes it
+// occupies, 0 if it is not complete yet, or SIZE_MAX if the stream is corrupt.
+std::size_t nextMessage(const std::uint8_t *data, std::size_t size, Message &message);
+
+bool readHello(const Message &message, Hello &hello);
+bool readSetRate(const Message &message, std::uint16_t &rateHz);
+bool readAck(const Message &message, std::uint32_t &sequence);
+bool readWelcome(const Message &message, Welcome &welcome);
+// Header only, to look up the base state before decoding.
+bool readFrameHeader(const Message &message, FrameHeader &header);
+// state must hold the base state on entry and receives the frame's state.
+bool readFrame(const Message &message, FrameHeader &header, State &state);
+
+} // namespace TelemetryProtocol
+
+#endif // TELEMETRYPROTOCOL_H
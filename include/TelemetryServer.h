@@ -0,0 +1,45 @@
+#ifndef TELEMETRYSERVER_H
+#define TELEMETRYSERVER_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <QThread>
+#include "AircraftData.h"
+#include "SnapshotSlot.h"
+
+class TelemetryServerWorker;
+
+// Fans the live AircraftData out to any number of TCP subscribers using
+// TelemetryProtocol, so tablets and secondary panels share the dashboard's
+// single SimConnect connection.
+//
+// publish() only stores the snapshot in a SnapshotSlot. Sockets, encoding
+// and per-client timers live on the server's own thread, which samples the
+// slot at each client's requested rate. A client that falls behind (full
+// socket buffer or too many unacknowledged frames) simply misses frames;
+// nothing ever waits on it.
+class TelemetryServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Highest update rate a client can ask for
+    static constexpr int MaxRateHz = 240;
+
+    explicit TelemetryServer(QObject *parent = nullptr);
+    ~TelemetryServer() override;
+
+    bool listen(const QHostAddress &address, quint16 port);
+    void close();
+
+public slots:
+    // Must only be called from one thread at a time.
+    void publish(const AircraftData &data) { m_latest.publish(data); }
+
+private:
+    SnapshotSlot<AircraftData> m_latest;
+    QThread m_thread;
+    TelemetryServerWorker *m_worker = nullptr;
+};
+
+#endif // TELEMETRYSERVER_H
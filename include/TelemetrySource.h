@@ -0,0 +1,70 @@
+#ifndef TELEMETRYSOURCE_H
+#define TELEMETRYSOURCE_H
+
+#include <QObject>
+#include "AircraftData.h"
+#include "TrafficStore.h"
+
+// Interface implemented by every backend that can feed the dashboard:
+// the SimConnect client on Windows and the synthetic generator used for
+// Linux builds, profiling and load tests.
+class TelemetrySource : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum EVENT_ID
+    {
+        EVENT_TOGGLE_FLIGHT_DIRECTOR,
+        EVENT_AP_MASTER,
+        EVENT_TOGGLE_NAV_GPS,
+        EVENT_AP_NAV1_HOLD,
+        EVENT_AP_APR_HOLD,
+        EVENT_AP_BC_HOLD,
+        EVENT_AP_WING_LEVELER,
+        EVENT_AP_ALT_HOLD,
+        EVENT_AP_VS_HOLD,
+        EVENT_AP_FLC_HOLD,
+        EVENT_HEADING_BUG_SET,
+        EVENT_AP_SPD_VAR_SET,
+        EVENT_AP_ALT_VAR_SET,
+        EVENT_AP_VS_VAR_SET,
+        EVENT_AUTO_THROTTLE_ARM,
+        EVENT_TOGGLE_ENGINE1_STARTER,
+        EVENT_TOGGLE_ENGINE2_STARTER,
+        EVENT_TOGGLE_ENGINE3_STARTER,
+        EVENT_TOGGLE_ENGINE4_STARTER,
+        EVENT_ENGINE_AUTO_SHUTDOWN,
+        EVENT_GEAR_UP,
+        EVENT_GEAR_DOWN,
+        EVENT_FLAPS_UP,
+        EVENT_FLAPS_DOWN,
+        EVENT_PARKING_BRAKES,
+        EVENT_SPOILERS_ARM
+    };
+    Q_ENUM(EVENT_ID)
+
+    explicit TelemetrySource(QObject *parent = nullptr) : QObject(parent) {}
+    ~TelemetrySource() override = default;
+
+    virtual bool isConnected() const = 0;
+
+public slots:
+    virtual void connectToSim() = 0;
+    virtual void disconnectFromSim() = 0;
+    // Called from the CommandPipeline worker thread, so it must be thread-safe
+    virtual void transmitEvent(EVENT_ID eventId, quint32 data = 0) = 0;
+
+signals:
+    void connected();
+    void disconnected();
+    void aircraftDataUpdated(const AircraftData &data);
+    // Every decoded snapshot, emitted on the thread that produced it and
+    // before any coalescing for the UI. Receivers must be connected with
+    // Qt::DirectConnection and must neither block nor touch the GUI.
+    void snapshotDecoded(const AircraftData &data);
+    // Positions of the aircraft around the own ship, a few times a second
+    void trafficUpdated(const TrafficBatch &batch);
+};
+
+#endif // TELEMETRYSOURCE_H
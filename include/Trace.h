@@ -0,0 +1,70 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Lightweight scoped trace spans for the hot paths, exported as Chrome
+// trace-event JSON (chrome://tracing, ui.perfetto.dev).
+//
+//   void Foo::bar() { TRACE_SCOPE("Foo::bar"); ... }
+//
+// While tracing is disabled a span costs one relaxed atomic load. Enabled
+// spans go into a fixed-size ring buffer owned by the recording thread, so
+// only the most recent events of each thread are kept. Span names must be
+// string literals or otherwise outlive the trace.
+namespace Trace {
+
+inline std::atomic<bool> g_enabled { false };
+
+inline bool enabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+inline std::int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Enabling clears previously recorded events.
+void setEnabled(bool enabled);
+
+void record(const char *name, std::int64_t startNs, std::int64_t endNs);
+
+// Writes the recorded events of all threads. Call with tracing disabled;
+// spans still being recorded by other threads may otherwise be torn.
+bool dumpChromeJson(const std::string &path);
+
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : m_name(name)
+        , m_start(enabled() ? now() : 0)
+    {
+    }
+    ~Scope()
+    {
+        if (m_start && enabled()) {
+            record(m_name, m_start, now());
+        }
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    std::int64_t m_start;
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+
+#endif // TRACE_H
@@ -0,0 +1,49 @@
+#ifndef TRAFFICDISPLAY_H
+#define TRAFFICDISPLAY_H
+
+#include <vector>
+#include "InstrumentWidget.h"
+#include "ReadoutRenderer.h"
+#include "TrafficStore.h"
+
+// Heading-up traffic awareness display. Shows the contacts returned by a
+// TrafficStore query around the own ship, with TCAS style symbols chosen
+// from range, closure and relative altitude, and a relative altitude tag in
+// hundreds of feet.
+class TrafficDisplay : public InstrumentWidget
+{
+    Q_OBJECT
+
+public:
+    // Contacts drawn at most; the rest would only clutter the display
+    static constexpr int MaxContacts = 32;
+
+    explicit TrafficDisplay(QWidget *parent = nullptr);
+
+    void setRange(float rangeNm);
+    float range() const { return m_range_nm; }
+
+    // Contacts closest first, as returned by TrafficStore::nearest().
+    void setTraffic(const std::vector<TrafficStore::Contact> &contacts, float ownshipTrackDeg);
+    void clearTraffic();
+
+protected:
+    void drawStaticBackground(QPainter &painter) override;
+    void drawDynamicLayer(QPainter &painter) override;
+    void staticLayersRebuilt() override;
+    void captureRenderState() override;
+
+private:
+    void drawContact(QPainter &painter, const TrafficStore::Contact &contact) const;
+
+    float m_range_nm = 20.0f;
+    float m_track_degrees = 0.0f;
+    std::vector<TrafficStore::Contact> m_contacts;
+    // Values of the frame being drawn
+    float m_render_range_nm = 20.0f;
+    float m_render_track_degrees = 0.0f;
+    std::vector<TrafficStore::Contact> m_render_contacts;
+    ReadoutRenderer m_altitude_readout;
+};
+
+#endif // TRAFFICDISPLAY_H
@@ -0,0 +1,112 @@
+#ifndef TRAFFICSTORE_H
+#define TRAFFICSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Position and motion of one aircraft, as requested from SimConnect for
+// AI and multiplayer traffic (and for the own ship).
+struct TrafficSample {
+    double latitudeDeg = 0.0;
+    double longitudeDeg = 0.0;
+    double altitudeFt = 0.0;
+    double groundSpeedKt = 0.0;
+    double trackDeg = 0.0;
+    double verticalSpeedFpm = 0.0;
+};
+
+// Traffic reports handed from a telemetry source to the UI in one go.
+struct TrafficBatch {
+    std::int64_t timeNs = 0; // LatencyHistogram::now()
+    bool hasOwnship = false;
+    TrafficSample ownship;
+    std::vector<std::uint32_t> objectIds;
+    std::vector<TrafficSample> samples;
+    // Set when the batch holds every object in range, so anything not in it
+    // has left (or was removed from the sim) and can be evicted.
+    bool completeSweep = false;
+};
+
+// Traffic around the own ship, stored as structure of arrays keyed by
+// SimConnect object ID, with a uniform grid over a local flat-earth plane
+// for spatial queries. Inserts, updates and evictions are incremental: an
+// object only moves between grid cells when it crosses a cell border, and
+// removal swaps the last object into the freed slot.
+//
+// The plane is anchored near the own ship and re-anchored (one O(n) pass)
+// once the own ship has travelled far from the anchor, which keeps the
+// equirectangular projection accurate for the ranges a traffic display uses.
+class TrafficStore
+{
+public:
+    struct Contact {
+        std::uint32_t objectId;
+        float distanceNm;
+        float bearingDeg;         // true bearing from the own ship
+        float relativeAltitudeFt; // positive above the own ship
+        float closureKt;          // positive while the distance shrinks
+        float verticalSpeedFpm;
+    };
+
+    static constexpr float CellSizeNm = 5.0f;
+
+    void setOwnship(const TrafficSample &sample);
+    bool hasOwnship() const { return m_has_ownship; }
+    float ownshipTrackDeg() const { return m_own_track; }
+
+    void upsert(std::uint32_t objectId, const TrafficSample &sample, std::int64_t timeNs);
+    bool remove(std::uint32_t objectId);
+    // Removes every object last updated before timeNs; returns how many.
+    std::size_t evictOlderThan(std::int64_t timeNs);
+    void apply(const TrafficBatch &batch);
+    void clear();
+
+    std::size_t size() const { return m_ids.size(); }
+
+    // Up to count objects within rangeNm of the own ship, closest first.
+    void nearest(std::size_t count, float rangeNm, std::vector<Contact> &contacts) const;
+    bool contact(std::uint32_t objectId, Contact &result) const;
+
+private:
+    void anchorAt(double latitudeDeg, double longitudeDeg);
+    void project(const TrafficSample &sample, float &x, float &y) const;
+    static void velocity(const TrafficSample &sample, float &vx, float &vy);
+    static std::uint64_t cellKey(int cx, int cy);
+    static int cellCoordinate(float value);
+    void addToCell(std::uint32_t index);
+    void removeFromCell(std::uint32_t index);
+    Contact makeContact(std::uint32_t index) const;
+
+    // One entry per object
+    std::vector<std::uint32_t> m_ids;
+    std::vector<double> m_latitude;
+    std::vector<double> m_longitude;
+    std::vector<float> m_x; // nm east of the anchor
+    std::vector<float> m_y; // nm north of the anchor
+    std::vector<float> m_altitude;
+    std::vector<float> m_vx; // kt east
+    std::vector<float> m_vy; // kt north
+    std::vector<float> m_vertical_speed;
+    std::vector<std::int64_t> m_updated_ns;
+    std::vector<std::uint64_t> m_cell;
+
+    std::unordered_map<std::uint32_t, std::uint32_t> m_index;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells;
+
+    bool m_anchored = false;
+    double m_anchor_latitude = 0.0;
+    double m_anchor_longitude = 0.0;
+    double m_anchor_cos = 1.0;
+
+    bool m_has_ownship = false;
+    float m_own_x = 0.0f;
+    float m_own_y = 0.0f;
+    float m_own_altitude = 0.0f;
+    float m_own_vx = 0.0f;
+    float m_own_vy = 0.0f;
+    float m_own_track = 0.0f;
+};
+
+#endif // TRAFFICSTORE_H
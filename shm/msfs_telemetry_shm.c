@@ -0,0 +1,337 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "msfs_telemetry_shm.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Reads retry this often before giving up with MSFS_TELEMETRY_BUSY */
+#define MAX_READ_ATTEMPTS 64
+
+/* --- Atomics ---------------------------------------------------------------- */
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#if defined(_M_ARM64)
+static uint64_t load_acquire(const volatile uint64_t *p) { return __ldar64((unsigned __int64 volatile *)p); }
+static void store_release(volatile uint64_t *p, uint64_t v) { __stlr64((unsigned __int64 volatile *)p, v); }
+static void fence_acquire(void) { __dmb(_ARM64_BARRIER_ISHLD); }
+static void fence_release(void) { __dmb(_ARM64_BARRIER_ISH); }
+#else
+/* x86-64 loads and stores already have acquire / release ordering */
+static uint64_t load_acquire(const volatile uint64_t *p) { uint64_t v = *p; _ReadWriteBarrier(); return v; }
+static void store_release(volatile uint64_t *p, uint64_t v) { _ReadWriteBarrier(); *p = v; }
+static void fence_acquire(void) { _ReadWriteBarrier(); }
+static void fence_release(void) { _ReadWriteBarrier(); }
+#endif
+static uint64_t load_relaxed(const volatile uint64_t *p) { return *p; }
+static void store_relaxed(volatile uint64_t *p, uint64_t v) { *p = v; }
+#else
+static uint64_t load_acquire(const volatile uint64_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static void store_release(volatile uint64_t *p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+static void fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static void fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+static uint64_t load_relaxed(const volatile uint64_t *p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+static void store_relaxed(volatile uint64_t *p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_RELAXED); }
+#endif
+
+/* --- Seqlock slots ------------------------------------------------------------ */
+
+static int read_slot(const msfs_telemetry_slot *slot, msfs_telemetry_frame *frame)
+{
+    int attempt;
+    for (attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t before = load_acquire(&slot->version);
+        if (before == 0) {
+            return MSFS_TELEMETRY_EMPTY;
+        }
+        if (before & 1) {
+            continue; /* write in progress */
+        }
+        memcpy(frame, (const void *)&slot->frame, sizeof(*frame));
+        fence_acquire();
+        if (load_relaxed(&slot->version) == before) {
+            return MSFS_TELEMETRY_OK;
+        }
+    }
+    return MSFS_TELEMETRY_BUSY;
+}
+
+static void write_slot(msfs_telemetry_slot *slot, const msfs_telemetry_frame *frame)
+{
+    uint64_t version = load_relaxed(&slot->version);
+    store_relaxed(&slot->version, version + 1);
+    fence_release();
+    memcpy((void *)&slot->frame, frame, sizeof(*frame));
+    store_release(&slot->version, version + 2);
+}
+
+/* --- Readers ------------------------------------------------------------------ */
+
+uint64_t msfs_telemetry_head(const msfs_telemetry_shm *shm)
+{
+    return load_acquire(&shm->head);
+}
+
+int msfs_telemetry_writer_running(const msfs_telemetry_shm *shm)
+{
+    return shm->writer_running != 0;
+}
+
+int msfs_telemetry_read_latest(const msfs_telemetry_shm *shm, msfs_telemetry_frame *frame)
+{
+    return read_slot(&shm->latest, frame);
+}
+
+int msfs_telemetry_read(const msfs_telemetry_shm *shm, uint64_t sequence, msfs_telemetry_frame *frame)
+{
+    int result;
+    if (sequence == 0 || sequence > msfs_telemetry_head(shm)) {
+        return MSFS_TELEMETRY_EMPTY;
+    }
+    result = read_slot(&shm->ring[sequence % MSFS_TELEMETRY_SHM_RING_SIZE], frame);
+    if (result == MSFS_TELEMETRY_OK && frame->sequence != sequence) {
+        return MSFS_TELEMETRY_OVERWRITTEN;
+    }
+    return result;
+}
+
+/* --- Writer ------------------------------------------------------------------- */
+
+uint64_t msfs_telemetry_write(msfs_telemetry_shm *shm, msfs_telemetry_frame *frame)
+{
+    frame->sequence = load_relaxed(&shm->head) + 1;
+    write_slot(&shm->ring[frame->sequence % MSFS_TELEMETRY_SHM_RING_SIZE], frame);
+    write_slot(&shm->latest, frame);
+    store_release(&shm->head, frame->sequence);
+    return frame->sequence;
+}
+
+/* --- Mapping ------------------------------------------------------------------ */
+
+static void os_name(const char *name, char *out, size_t size)
+{
+#ifdef _WIN32
+    snprintf(out, size, "Local\\%s", name ? name : MSFS_TELEMETRY_SHM_DEFAULT_NAME);
+#else
+    snprintf(out, size, "/%s", name ? name : MSFS_TELEMETRY_SHM_DEFAULT_NAME);
+#endif
+}
+
+static int process_alive(uint64_t pid)
+{
+#ifdef _WIN32
+    DWORD code = 0;
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, (DWORD)pid);
+    int alive;
+    if (!process) {
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    }
+    alive = GetExitCodeProcess(process, &code) && code == STILL_ACTIVE;
+    CloseHandle(process);
+    return alive;
+#else
+    return pid != 0 && (kill((pid_t)pid, 0) == 0 || errno == EPERM);
+#endif
+}
+
+/* The header fields a writer sets first, before anything else */
+static int writer_alive(const msfs_telemetry_shm *shm)
+{
+    return shm->writer_running && process_alive(shm->writer_pid);
+}
+
+#ifndef _WIN32
+/* Maps name for writing, creating it if needed. An existing region is only
+ * replaced when its writer is gone, and then by unlinking it rather than
+ * truncating, so readers that have it mapped cannot fault. */
+static int create_posix_region(msfs_telemetry_mapping *mapping)
+{
+    const size_t size = mapping->size;
+    int attempt;
+    for (attempt = 0; attempt < 2; ++attempt) {
+        struct stat info;
+        void *address;
+        int in_use;
+        int fd = shm_open(mapping->name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd >= 0) {
+            /* Fresh objects read as zeroes */
+            if (ftruncate(fd, (off_t)size) != 0) {
+                close(fd);
+                shm_unlink(mapping->name);
+                return MSFS_TELEMETRY_ERROR;
+            }
+            mapping->fd = fd;
+            return MSFS_TELEMETRY_OK;
+        }
+        if (errno != EEXIST) {
+            return MSFS_TELEMETRY_ERROR;
+        }
+
+        fd = shm_open(mapping->name, O_RDONLY, 0);
+        if (fd < 0) {
+            continue; /* unlinked meanwhile */
+        }
+        in_use = 0;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(msfs_telemetry_shm)) {
+            address = mmap(NULL, sizeof(msfs_telemetry_shm), PROT_READ, MAP_SHARED, fd, 0);
+            if (address != MAP_FAILED) {
+                in_use = writer_alive((const msfs_telemetry_shm *)address);
+                munmap(address, sizeof(msfs_telemetry_shm));
+            }
+        }
+        close(fd);
+        if (in_use) {
+            return MSFS_TELEMETRY_IN_USE;
+        }
+        shm_unlink(mapping->name); /* left behind by a writer that died */
+    }
+    return MSFS_TELEMETRY_ERROR;
+}
+#endif
+
+static int map_region(const char *name, int writable, msfs_telemetry_mapping *mapping)
+{
+    const size_t size = sizeof(msfs_telemetry_shm);
+    memset(mapping, 0, sizeof(*mapping));
+    mapping->fd = -1;
+    mapping->writable = writable;
+    mapping->size = size;
+    os_name(name, mapping->name, sizeof(mapping->name));
+
+#ifdef _WIN32
+    if (writable) {
+        mapping->handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, mapping->name);
+    } else {
+        mapping->handle = OpenFileMappingA(FILE_MAP_READ, FALSE, mapping->name);
+    }
+    if (!mapping->handle) {
+        return MSFS_TELEMETRY_ERROR;
+    }
+    /* A mapping that already exists is kept open by its writer or readers */
+    const int existed = writable && GetLastError() == ERROR_ALREADY_EXISTS;
+    mapping->shm = (msfs_telemetry_shm *)MapViewOfFile(mapping->handle, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (mapping->shm && existed) {
+        if (writer_alive(mapping->shm)) {
+            /* Not ours: leave it untouched */
+            UnmapViewOfFile(mapping->shm);
+            CloseHandle(mapping->handle);
+            mapping->shm = NULL;
+            mapping->handle = NULL;
+            return MSFS_TELEMETRY_IN_USE;
+        }
+        /* Its writer died; readers see the magic vanish and reopen */
+        store_release(&mapping->shm->magic, 0);
+        memset(mapping->shm, 0, size);
+    }
+#else
+    if (writable) {
+        int result = create_posix_region(mapping);
+        if (result != MSFS_TELEMETRY_OK) {
+            return result;
+        }
+    } else {
+        struct stat info;
+        mapping->fd = shm_open(mapping->name, O_RDONLY, 0);
+        if (mapping->fd < 0) {
+            return MSFS_TELEMETRY_ERROR;
+        }
+        if (fstat(mapping->fd, &info) != 0 || (size_t)info.st_size < size) {
+            msfs_telemetry_close(mapping);
+            return MSFS_TELEMETRY_INCOMPATIBLE;
+        }
+    }
+    void *address = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, mapping->fd, 0);
+    mapping->shm = address == MAP_FAILED ? NULL : (msfs_telemetry_shm *)address;
+#endif
+    if (!mapping->shm) {
+        msfs_telemetry_close(mapping);
+        return MSFS_TELEMETRY_ERROR;
+    }
+    return MSFS_TELEMETRY_OK;
+}
+
+int msfs_telemetry_open(const char *name, msfs_telemetry_mapping *mapping)
+{
+    int result = map_region(name, 0, mapping);
+    if (result != MSFS_TELEMETRY_OK) {
+        return result;
+    }
+    if (load_acquire(&mapping->shm->magic) != MSFS_TELEMETRY_SHM_MAGIC
+        || mapping->shm->version != MSFS_TELEMETRY_SHM_VERSION
+        || mapping->shm->field_count != MSFS_TELEMETRY_FIELD_COUNT
+        || mapping->shm->slot_size != sizeof(msfs_telemetry_slot)
+        || mapping->shm->ring_size != MSFS_TELEMETRY_SHM_RING_SIZE) {
+        msfs_telemetry_close(mapping);
+        return MSFS_TELEMETRY_INCOMPATIBLE;
+    }
+    return MSFS_TELEMETRY_OK;
+}
+
+int msfs_telemetry_create(const char *name, msfs_telemetry_mapping *mapping)
+{
+    msfs_telemetry_shm *shm;
+    int result = map_region(name, 1, mapping);
+    if (result != MSFS_TELEMETRY_OK) {
+        return result;
+    }
+    /* map_region hands out a zeroed region. Claim it first, so another
+     * writer starting now sees it in use. */
+    shm = mapping->shm;
+#ifdef _WIN32
+    shm->writer_pid = GetCurrentProcessId();
+#else
+    shm->writer_pid = (uint64_t)getpid();
+#endif
+    shm->writer_running = 1;
+    shm->version = MSFS_TELEMETRY_SHM_VERSION;
+    shm->field_count = (uint32_t)MSFS_TELEMETRY_FIELD_COUNT;
+    shm->slot_size = (uint32_t)sizeof(msfs_telemetry_slot);
+    shm->ring_size = MSFS_TELEMETRY_SHM_RING_SIZE;
+    /* Readers check the magic first, so it is published last */
+    store_release(&shm->magic, MSFS_TELEMETRY_SHM_MAGIC);
+    return MSFS_TELEMETRY_OK;
+}
+
+void msfs_telemetry_close(msfs_telemetry_mapping *mapping)
+{
+    if (mapping->shm && mapping->writable) {
+        mapping->shm->writer_running = 0;
+    }
+#ifdef _WIN32
+    if (mapping->shm) {
+        UnmapViewOfFile(mapping->shm);
+    }
+    if (mapping->handle) {
+        CloseHandle(mapping->handle);
+    }
+#else
+    if (mapping->shm) {
+        munmap(mapping->shm, mapping->size);
+    }
+    if (mapping->fd >= 0) {
+        close(mapping->fd);
+        /* Readers keep their mapping; new ones find nothing */
+        if (mapping->writable) {
+            shm_unlink(mapping->name);
+        }
+    }
+#endif
+    mapping->shm = NULL;
+    mapping->handle = NULL;
+    mapping->fd = -1;
+}
@@ -0,0 +1,132 @@
+/*
+ * Shared-memory telemetry bus published by the MSFS Dashboard.
+ *
+ * The dashboard writes every decoded AircraftData snapshot into a named
+ * shared-memory region ("/<name>" via POSIX shm on Linux, "Local\<name>" as
+ * a file mapping on Windows). Local processes map it read-only and read at
+ * memory speed without any system call per read.
+ *
+ * Layout: a 64 byte header, the latest-frame slot, then a ring of the most
+ * recent MSFS_TELEMETRY_SHM_RING_SIZE frames; frame n lives in
+ * ring[n % MSFS_TELEMETRY_SHM_RING_SIZE]. Every slot is a seqlock: its
+ * version is odd while the single writer updates it, so readers copy the
+ * frame and retry if the version changed meanwhile. Readers never write to
+ * the region and never block the writer.
+ *
+ * Use the reader functions below rather than reading the structures
+ * directly; they implement the seqlock protocol for C11, GCC, Clang and MSVC.
+ */
+#ifndef MSFS_TELEMETRY_SHM_H
+#define MSFS_TELEMETRY_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSFS_TELEMETRY_SHM_DEFAULT_NAME "msfs_dashboard_telemetry"
+#define MSFS_TELEMETRY_SHM_MAGIC 0x3153484D5346534DULL /* "MSFSMHS1" */
+#define MSFS_TELEMETRY_SHM_VERSION 2
+#define MSFS_TELEMETRY_SHM_RING_SIZE 256
+
+/* Return codes */
+#define MSFS_TELEMETRY_OK 0
+#define MSFS_TELEMETRY_EMPTY 1        /* nothing written there (yet) */
+#define MSFS_TELEMETRY_BUSY 2         /* kept racing with the writer; retry */
+#define MSFS_TELEMETRY_OVERWRITTEN 3  /* frame already replaced by a newer one */
+#define MSFS_TELEMETRY_ERROR (-1)     /* region missing or cannot be mapped */
+#define MSFS_TELEMETRY_INCOMPATIBLE (-2)
+#define MSFS_TELEMETRY_IN_USE (-3)     /* another running writer owns the region */
+
+/* Aircraft state, laid out exactly like the dashboard's AircraftData schema. */
+typedef struct msfs_telemetry_data {
+    float gear_total_extended_pct;
+    int32_t parking_brake_position;
+    int32_t autopilot_master;
+    float attitude_bank_degrees;
+    float attitude_pitch_degrees;
+    int32_t gear_handle_position;
+    float plane_heading_degrees_true;
+    int32_t gear_damage_by_speed;
+    int32_t gear_warning_center;
+    int32_t gear_warning_left;
+    int32_t gear_warning_right;
+    float gear_pos_center;
+    float gear_pos_left;
+    float gear_pos_right;
+    float eng_n1_1;
+    float eng_n1_2;
+    float eng_n1_3;
+    float eng_n1_4;
+    float throttle_1;
+    float throttle_2;
+    float throttle_3;
+    float throttle_4;
+    float plane_alt_above_ground;  /* feet, since version 2 */
+} msfs_telemetry_data;
+
+#define MSFS_TELEMETRY_FIELD_COUNT (sizeof(msfs_telemetry_data) / 4)
+
+typedef struct msfs_telemetry_frame {
+    uint64_t sequence;          /* 1 for the first frame, +1 per snapshot */
+    int64_t received_ns;        /* monotonic clock (CLOCK_MONOTONIC / QPC) when it arrived from the sim */
+    int64_t published_unix_ns;  /* wall clock when it was published */
+    msfs_telemetry_data data;
+} msfs_telemetry_frame;
+
+typedef struct msfs_telemetry_slot {
+    volatile uint64_t version;  /* seqlock; 0 = never written, odd = being written */
+    uint64_t reserved;
+    msfs_telemetry_frame frame;
+} msfs_telemetry_slot;
+
+typedef struct msfs_telemetry_shm {
+    volatile uint64_t magic;    /* MSFS_TELEMETRY_SHM_MAGIC once initialized */
+    uint32_t version;
+    uint32_t field_count;
+    uint32_t slot_size;
+    uint32_t ring_size;
+    uint64_t writer_pid;
+    volatile uint64_t head;     /* sequence of the newest complete frame */
+    volatile uint32_t writer_running;
+    uint8_t reserved[20];
+    msfs_telemetry_slot latest;
+    msfs_telemetry_slot ring[MSFS_TELEMETRY_SHM_RING_SIZE];
+} msfs_telemetry_shm;
+
+typedef struct msfs_telemetry_mapping {
+    msfs_telemetry_shm *shm;
+    size_t size;
+    void *handle;  /* Windows file mapping */
+    int fd;        /* POSIX shm descriptor */
+    int writable;
+    char name[128];
+} msfs_telemetry_mapping;
+
+/* Maps an existing region read-only; name NULL selects the default. */
+int msfs_telemetry_open(const char *name, msfs_telemetry_mapping *mapping);
+void msfs_telemetry_close(msfs_telemetry_mapping *mapping);
+
+/* Sequence of the newest frame, 0 before the first one. */
+uint64_t msfs_telemetry_head(const msfs_telemetry_shm *shm);
+/* Non-zero while a dashboard is publishing. */
+int msfs_telemetry_writer_running(const msfs_telemetry_shm *shm);
+int msfs_telemetry_read_latest(const msfs_telemetry_shm *shm, msfs_telemetry_frame *frame);
+/* Reads frame sequence from the ring; frames older than the ring size are gone. */
+int msfs_telemetry_read(const msfs_telemetry_shm *shm, uint64_t sequence, msfs_telemetry_frame *frame);
+
+/* Writer side, used by the dashboard. Only one writer per region: creating
+ * fails with MSFS_TELEMETRY_IN_USE while the writer of an existing region is
+ * still alive. A region left behind by a writer that died is replaced;
+ * readers still mapping it keep their (stale) view. */
+int msfs_telemetry_create(const char *name, msfs_telemetry_mapping *mapping);
+/* Publishes frame->data, filling in the sequence; returns the sequence. */
+uint64_t msfs_telemetry_write(msfs_telemetry_shm *shm, msfs_telemetry_frame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MSFS_TELEMETRY_SHM_H */
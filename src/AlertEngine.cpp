@@ -0,0 +1,655 @@
+#include "AlertEngine.h"
+#include <QFile>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <loguru.hpp>
+
+namespace {
+
+struct Token {
+    enum Kind { End, Identifier, Number, String, SimVar, Symbol };
+    Kind kind = End;
+    std::string text;
+    double number = 0.0;
+    int column = 0;
+};
+
+// Compiles the rules of one source into code with offsets relative to its
+// own start. Expressions are emitted while parsing, so there is no tree.
+class RuleCompiler
+{
+public:
+    struct CompiledRule {
+        AlertEngine::Rule rule;
+        std::uint64_t inputs = 0;
+        std::uint32_t setCode = 0;
+        std::uint32_t clearCode = AlertEngine::NoCode;
+    };
+
+    std::vector<CompiledRule> rules;
+    std::vector<AlertEngine::Instruction> code;
+    std::string error;
+
+    bool compileLine(const std::string &line)
+    {
+        m_line = &line;
+        m_position = 0;
+        if (!next()) {
+            return false;
+        }
+        if (m_token.kind == Token::End) {
+            return true; // blank or comment
+        }
+
+        CompiledRule compiled;
+        if (m_token.kind != Token::Identifier || isKeyword(m_token.text)) {
+            return fail("expected a rule name");
+        }
+        compiled.rule.name = m_token.text;
+        if (!next()) {
+            return false;
+        }
+        if (m_token.kind == Token::String) {
+            compiled.rule.message = m_token.text;
+            if (!next()) {
+                return false;
+            }
+        }
+        if (isWord("priority")) {
+            if (!next()) {
+                return false;
+            }
+            if (m_token.kind != Token::Number) {
+                return fail("expected a priority");
+            }
+            compiled.rule.priority = static_cast<int>(m_token.number);
+            if (!next()) {
+                return false;
+            }
+        }
+
+        if (!expectWord("when")) {
+            return false;
+        }
+        compiled.setCode = static_cast<std::uint32_t>(code.size());
+        if (!condition(compiled.inputs) || !optionalDuration(compiled.rule.setDelayNs)) {
+            return false;
+        }
+        if (isWord("clear")) {
+            if (!next() || !expectWord("when")) {
+                return false;
+            }
+            compiled.clearCode = static_cast<std::uint32_t>(code.size());
+            if (!condition(compiled.inputs) || !optionalDuration(compiled.rule.clearDelayNs)) {
+                return false;
+            }
+        }
+        if (m_token.kind != Token::End) {
+            return fail("unexpected '" + m_token.text + "'");
+        }
+        rules.push_back(compiled);
+        return true;
+    }
+
+    int errorColumn() const { return m_token.column; }
+
+private:
+    static bool isKeyword(const std::string &word)
+    {
+        static const char *const keywords[] = { "when", "for", "clear", "priority", "and", "or", "not", "abs", "true", "false" };
+        return std::find_if(std::begin(keywords), std::end(keywords), [&](const char *keyword) { return word == keyword; }) != std::end(keywords);
+    }
+
+    bool fail(const std::string &message)
+    {
+        if (error.empty()) {
+            error = message;
+        }
+        return false;
+    }
+
+    bool isWord(const char *word) const { return m_token.kind == Token::Identifier && m_token.text == word; }
+    bool isSymbol(const char *symbol) const { return m_token.kind == Token::Symbol && m_token.text == symbol; }
+
+    bool expectWord(const char *word)
+    {
+        if (!isWord(word)) {
+            return fail(std::string("expected '") + word + "'");
+        }
+        return next();
+    }
+
+    bool next()
+    {
+        const std::string &line = *m_line;
+        while (m_position < line.size() && std::isspace(static_cast<unsigned char>(line[m_position]))) {
+            ++m_position;
+        }
+        m_token = Token();
+        m_token.column = static_cast<int>(m_position) + 1;
+        if (m_position >= line.size() || line[m_position] == '#') {
+            return true;
+        }
+
+        const char c = line[m_position];
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            const std::size_t start = m_position;
+            while (m_position < line.size() && (std::isalnum(static_cast<unsigned char>(line[m_position])) || line[m_position] == '_')) {
+                ++m_position;
+            }
+            m_token.kind = Token::Identifier;
+            m_token.text = line.substr(start, m_position - start);
+            return true;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            // Parsed by hand; strtod would follow the decimal point of the locale
+            const std::size_t start = m_position;
+            double value = 0.0;
+            double scale = 0.0;
+            bool digits = false;
+            for (; m_position < line.size(); ++m_position) {
+                const char d = line[m_position];
+                if (d == '.' && scale == 0.0) {
+                    scale = 1.0;
+                } else if (std::isdigit(static_cast<unsigned char>(d))) {
+                    digits = true;
+                    value = value * 10.0 + (d - '0');
+                    scale *= 10.0;
+                } else {
+                    break;
+                }
+            }
+            m_token.text = line.substr(start, m_position - start);
+            if (!digits) {
+                return fail("malformed number");
+            }
+            m_token.kind = Token::Number;
+            m_token.number = scale > 1.0 ? value / scale : value;
+            return true;
+        }
+        if (c == '"' || c == '\'') {
+            const std::size_t close = line.find(c, m_position + 1);
+            if (close == std::string::npos) {
+                return fail("unterminated quote");
+            }
+            m_token.kind = c == '"' ? Token::String : Token::SimVar;
+            m_token.text = line.substr(m_position + 1, close - m_position - 1);
+            m_position = close + 1;
+            return true;
+        }
+
+        static const char *const symbols[] = { "<=", ">=", "==", "!=", "&&", "||", "<", ">", "(", ")", "+", "-", "*", "/", "!" };
+        for (const char *symbol : symbols) {
+            if (line.compare(m_position, std::strlen(symbol), symbol) == 0) {
+                m_token.kind = Token::Symbol;
+                m_token.text = symbol;
+                m_position += std::strlen(symbol);
+                return true;
+            }
+        }
+        m_token.text = std::string(1, c);
+        return fail("unexpected character '" + m_token.text + "'");
+    }
+
+    void emit(AlertEngine::Op op, std::uint16_t field = 0, float constant = 0.0f)
+    {
+        code.push_back({ op, field, constant });
+    }
+
+    bool push()
+    {
+        if (++m_depth > AlertEngine::MaxStackDepth) {
+            return fail("expression is nested too deeply");
+        }
+        return true;
+    }
+
+    bool condition(std::uint64_t &inputs)
+    {
+        m_depth = 0;
+        m_inputs = &inputs;
+        if (!orExpression()) {
+            return false;
+        }
+        emit(AlertEngine::Op::Return);
+        return true;
+    }
+
+    bool optionalDuration(std::int64_t &durationNs)
+    {
+        if (!isWord("for")) {
+            return true;
+        }
+        if (!next()) {
+            return false;
+        }
+        if (m_token.kind != Token::Number || m_token.number < 0.0) {
+            return fail("expected a duration");
+        }
+        const double value = m_token.number;
+        if (!next()) {
+            return false;
+        }
+        // Seconds unless a unit follows
+        double scale = 1e9;
+        if (isWord("ms") || isWord("s") || isWord("min")) {
+            scale = isWord("ms") ? 1e6 : (isWord("min") ? 60e9 : 1e9);
+            if (!next()) {
+                return false;
+            }
+        }
+        durationNs = static_cast<std::int64_t>(value * scale);
+        return true;
+    }
+
+    bool orExpression()
+    {
+        if (!andExpression()) {
+            return false;
+        }
+        while (isWord("or") || isSymbol("||")) {
+            if (!next() || !andExpression()) {
+                return false;
+            }
+            emit(AlertEngine::Op::Or);
+            --m_depth;
+        }
+        return true;
+    }
+
+    bool andExpression()
+    {
+        if (!notExpression()) {
+            return false;
+        }
+        while (isWord("and") || isSymbol("&&")) {
+            if (!next() || !notExpression()) {
+                return false;
+            }
+            emit(AlertEngine::Op::And);
+            --m_depth;
+        }
+        return true;
+    }
+
+    bool notExpression()
+    {
+        if (isWord("not") || isSymbol("!")) {
+            if (!next() || !notExpression()) {
+                return false;
+            }
+            emit(AlertEngine::Op::Not);
+            return true;
+        }
+        return comparison();
+    }
+
+    bool comparison()
+    {
+        if (!sum()) {
+            return false;
+        }
+        static const std::pair<const char *, AlertEngine::Op> operators[] = {
+            { "<", AlertEngine::Op::Less }, { "<=", AlertEngine::Op::LessEqual },
+            { ">", AlertEngine::Op::Greater }, { ">=", AlertEngine::Op::GreaterEqual },
+            { "==", AlertEngine::Op::Equal }, { "!=", AlertEngine::Op::NotEqual },
+        };
+        for (const auto &entry : operators) {
+            if (isSymbol(entry.first)) {
+                if (!next() || !sum()) {
+                    return false;
+                }
+                emit(entry.second);
+                --m_depth;
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool sum()
+    {
+        if (!product()) {
+            return false;
+        }
+        while (isSymbol("+") || isSymbol("-")) {
+            const AlertEngine::Op op = isSymbol("+") ? AlertEngine::Op::Add : AlertEngine::Op::Subtract;
+            if (!next() || !product()) {
+                return false;
+            }
+            emit(op);
+            --m_depth;
+        }
+        return true;
+    }
+
+    bool product()
+    {
+        if (!unary()) {
+            return false;
+        }
+        while (isSymbol("*") || isSymbol("/")) {
+            const AlertEngine::Op op = isSymbol("*") ? AlertEngine::Op::Multiply : AlertEngine::Op::Divide;
+            if (!next() || !unary()) {
+                return false;
+            }
+            emit(op);
+            --m_depth;
+        }
+        return true;
+    }
+
+    bool unary()
+    {
+        if (!isSymbol("-")) {
+            return primary();
+        }
+        if (!next()) {
+            return false;
+        }
+        if (m_token.kind == Token::Number) {
+            // Folded, so negative thresholds cost nothing at run time
+            if (!push()) {
+                return false;
+            }
+            emit(AlertEngine::Op::Constant, 0, static_cast<float>(-m_token.number));
+            return next();
+        }
+        if (!unary()) {
+            return false;
+        }
+        emit(AlertEngine::Op::Negate);
+        return true;
+    }
+
+    bool field(std::size_t index)
+    {
+        if (!push()) {
+            return false;
+        }
+        *m_inputs |= std::uint64_t(1) << index;
+        emit(AlertEngine::Op::Field, static_cast<std::uint16_t>(index));
+        return next();
+    }
+
+    bool primary()
+    {
+        if (m_token.kind == Token::Number) {
+            if (!push()) {
+                return false;
+            }
+            emit(AlertEngine::Op::Constant, 0, static_cast<float>(m_token.number));
+            return next();
+        }
+        if (isWord("true") || isWord("false")) {
+            if (!push()) {
+                return false;
+            }
+            emit(AlertEngine::Op::Constant, 0, isWord("true") ? 1.0f : 0.0f);
+            return next();
+        }
+        if (isWord("abs")) {
+            if (!next() || !isSymbol("(")) {
+                return fail("expected '(' after abs");
+            }
+            if (!next() || !orExpression()) {
+                return false;
+            }
+            if (!isSymbol(")")) {
+                return fail("expected ')'");
+            }
+            emit(AlertEngine::Op::Abs);
+            return next();
+        }
+        if (isSymbol("(")) {
+            if (!next() || !orExpression()) {
+                return false;
+            }
+            if (!isSymbol(")")) {
+                return fail("expected ')'");
+            }
+            return next();
+        }
+        if (m_token.kind == Token::Identifier && !isKeyword(m_token.text)) {
+            for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+                if (m_token.text == AircraftSchema::Fields[i].name) {
+                    return field(i);
+                }
+            }
+            return fail("unknown field '" + m_token.text + "'");
+        }
+        if (m_token.kind == Token::SimVar) {
+            for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+                const char *simVar = AircraftSchema::Fields[i].simVar;
+                if (std::equal(m_token.text.begin(), m_token.text.end(), simVar, simVar + std::strlen(simVar),
+                               [](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; })) {
+                    return field(i);
+                }
+            }
+            return fail("unknown SimVar '" + m_token.text + "'");
+        }
+        return fail(m_token.kind == Token::End ? "unexpected end of rule" : "unexpected '" + m_token.text + "'");
+    }
+
+    const std::string *m_line = nullptr;
+    std::size_t m_position = 0;
+    Token m_token;
+    int m_depth = 0;
+    std::uint64_t *m_inputs = nullptr;
+};
+
+} // namespace
+
+bool AlertEngine::compile(const std::string &text, const std::string &sourceName)
+{
+    RuleCompiler compiler;
+    std::unordered_map<std::string, int> names;
+    std::size_t lineStart = 0;
+    for (int lineNumber = 1; lineStart <= text.size(); ++lineNumber) {
+        std::size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos) {
+            lineEnd = text.size();
+        }
+        std::string line = text.substr(lineStart, lineEnd - lineStart);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        const std::size_t rulesBefore = compiler.rules.size();
+        if (!compiler.compileLine(line)) {
+            LOG_F(ERROR, "%s:%d:%d: %s", sourceName.c_str(), lineNumber, compiler.errorColumn(), compiler.error.c_str());
+            return false;
+        }
+        if (compiler.rules.size() > rulesBefore) {
+            const std::string &name = compiler.rules.back().rule.name;
+            auto previous = names.emplace(name, lineNumber);
+            if (!previous.second) {
+                LOG_F(ERROR, "%s:%d: rule %s was already defined on line %d", sourceName.c_str(), lineNumber, name.c_str(), previous.first->second);
+                return false;
+            }
+        }
+        lineStart = lineEnd + 1;
+    }
+
+    const std::uint32_t base = static_cast<std::uint32_t>(m_code.size());
+    m_code.insert(m_code.end(), compiler.code.begin(), compiler.code.end());
+    for (const RuleCompiler::CompiledRule &compiled : compiler.rules) {
+        int index = find(compiled.rule.name);
+        if (index < 0) {
+            index = static_cast<int>(m_rules.size());
+            m_rule_index.emplace(compiled.rule.name, static_cast<std::uint32_t>(index));
+            m_rules.emplace_back();
+            m_inputs.push_back(0);
+            m_set_code.push_back(0);
+            m_clear_code.push_back(NoCode);
+            m_set_condition.push_back(0);
+            m_clear_condition.push_back(0);
+            m_active.push_back(0);
+            m_deadline.push_back(0);
+            m_queued.push_back(0);
+        }
+        // A replaced rule starts over; its old code stays unreferenced
+        m_rules[index] = compiled.rule;
+        m_inputs[index] = compiled.inputs;
+        m_set_code[index] = base + compiled.setCode;
+        m_clear_code[index] = compiled.clearCode == NoCode ? NoCode : base + compiled.clearCode;
+        m_set_condition[index] = 0;
+        m_clear_condition[index] = 0;
+        m_active[index] = 0;
+        m_deadline[index] = 0;
+    }
+    LOG_F(INFO, "Compiled %zu alert rules from %s (%zu instructions in total)",
+          compiler.rules.size(), sourceName.c_str(), m_code.size());
+    return true;
+}
+
+bool AlertEngine::loadFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        LOG_F(ERROR, "Cannot open alert rules %s: %s", qPrintable(path), qPrintable(file.errorString()));
+        return false;
+    }
+    return compile(file.readAll().toStdString(), path.toStdString());
+}
+
+void AlertEngine::clear()
+{
+    *this = AlertEngine();
+}
+
+int AlertEngine::find(const std::string &name) const
+{
+    auto found = m_rule_index.find(name);
+    return found == m_rule_index.end() ? -1 : static_cast<int>(found->second);
+}
+
+void AlertEngine::reset()
+{
+    std::fill(m_set_condition.begin(), m_set_condition.end(), 0);
+    std::fill(m_clear_condition.begin(), m_clear_condition.end(), 0);
+    std::fill(m_active.begin(), m_active.end(), 0);
+    std::fill(m_deadline.begin(), m_deadline.end(), 0);
+    std::fill(m_queued.begin(), m_queued.end(), 0);
+    m_pending.clear();
+    m_transitions.clear();
+}
+
+bool AlertEngine::run(std::uint32_t offset) const
+{
+    float stack[MaxStackDepth];
+    int top = -1;
+    for (const Instruction *instruction = &m_code[offset];; ++instruction) {
+        switch (instruction->op) {
+            case Op::Field: stack[++top] = m_values[instruction->field]; break;
+            case Op::Constant: stack[++top] = instruction->constant; break;
+            case Op::Negate: stack[top] = -stack[top]; break;
+            case Op::Abs: stack[top] = std::fabs(stack[top]); break;
+            case Op::Not: stack[top] = stack[top] == 0.0f ? 1.0f : 0.0f; break;
+            case Op::Add: --top; stack[top] += stack[top + 1]; break;
+            case Op::Subtract: --top; stack[top] -= stack[top + 1]; break;
+            case Op::Multiply: --top; stack[top] *= stack[top + 1]; break;
+            case Op::Divide: --top; stack[top] /= stack[top + 1]; break;
+            case Op::Less: --top; stack[top] = stack[top] < stack[top + 1] ? 1.0f : 0.0f; break;
+            case Op::LessEqual: --top; stack[top] = stack[top] <= stack[top + 1] ? 1.0f : 0.0f; break;
+            case Op::Greater: --top; stack[top] = stack[top] > stack[top + 1] ? 1.0f : 0.0f; break;
+            case Op::GreaterEqual: --top; stack[top] = stack[top] >= stack[top + 1] ? 1.0f : 0.0f; break;
+            case Op::Equal: --top; stack[top] = stack[top] == stack[top + 1] ? 1.0f : 0.0f; break;
+            case Op::NotEqual: --top; stack[top] = stack[top] != stack[top + 1] ? 1.0f : 0.0f; break;
+            case Op::And: --top; stack[top] = (stack[top] != 0.0f && stack[top + 1] != 0.0f) ? 1.0f : 0.0f; break;
+            case Op::Or: --top; stack[top] = (stack[top] != 0.0f || stack[top + 1] != 0.0f) ? 1.0f : 0.0f; break;
+            case Op::Return: return stack[top] != 0.0f;
+        }
+    }
+}
+
+void AlertEngine::setActive(std::uint32_t index, bool active)
+{
+    m_active[index] = active ? 1 : 0;
+    m_deadline[index] = 0;
+    m_transitions.push_back(index);
+    // Only the condition watched in the new state is kept up to date
+    if (m_clear_code[index] != NoCode) {
+        if (active) {
+            m_clear_condition[index] = run(m_clear_code[index]) ? 1 : 0;
+        } else {
+            m_set_condition[index] = run(m_set_code[index]) ? 1 : 0;
+        }
+    }
+}
+
+void AlertEngine::update(std::uint32_t index, std::int64_t nowNs)
+{
+    // Waiting to activate on the set condition, or to clear on the clear
+    // condition (the negated set condition without one)
+    const bool active = m_active[index] != 0;
+    const bool holds = active ? (m_clear_code[index] == NoCode ? !m_set_condition[index] : m_clear_condition[index] != 0)
+                              : m_set_condition[index] != 0;
+    if (!holds) {
+        m_deadline[index] = 0;
+        return;
+    }
+    const std::int64_t delay = active ? m_rules[index].clearDelayNs : m_rules[index].setDelayNs;
+    if (delay == 0 || (m_deadline[index] != 0 && nowNs >= m_deadline[index])) {
+        setActive(index, !active);
+    } else if (m_deadline[index] == 0) {
+        m_deadline[index] = nowNs + delay;
+        if (!m_queued[index]) {
+            m_queued[index] = 1;
+            m_pending.push_back(index);
+        }
+    }
+}
+
+const std::vector<std::uint32_t> &AlertEngine::evaluate(const AircraftData &data, std::uint64_t changedFields, std::int64_t nowNs)
+{
+    m_transitions.clear();
+    for (std::size_t field = 0; field < AircraftSchema::FieldCount; ++field) {
+        if (changedFields & (std::uint64_t(1) << field)) {
+            m_values[field] = static_cast<float>(AircraftSchema::value(data, field));
+        }
+    }
+
+    if (changedFields) {
+        const std::uint32_t count = static_cast<std::uint32_t>(m_rules.size());
+        for (std::uint32_t i = 0; i < count; ++i) {
+            if (m_inputs[i] & changedFields) {
+                // An active rule with a clear condition only watches that one
+                if (m_active[i] && m_clear_code[i] != NoCode) {
+                    m_clear_condition[i] = run(m_clear_code[i]) ? 1 : 0;
+                } else {
+                    m_set_condition[i] = run(m_set_code[i]) ? 1 : 0;
+                }
+                update(i, nowNs);
+            }
+        }
+    }
+
+    // Timers: only rules that are waiting out a duration
+    for (std::size_t p = 0; p < m_pending.size();) {
+        const std::uint32_t index = m_pending[p];
+        if (m_deadline[index] != 0) {
+            update(index, nowNs);
+        }
+        if (m_deadline[index] == 0) {
+            m_queued[index] = 0;
+            m_pending[p] = m_pending.back();
+            m_pending.pop_back();
+        } else {
+            ++p;
+        }
+    }
+    return m_transitions;
+}
+
+std::int64_t AlertEngine::nextDeadline() const
+{
+    std::int64_t next = 0;
+    for (std::uint32_t index : m_pending) {
+        if (m_deadline[index] != 0 && (next == 0 || m_deadline[index] < next)) {
+            next = m_deadline[index];
+        }
+    }
+    return next;
+}
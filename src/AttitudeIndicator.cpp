@@ -1,46 +1,91 @@
 #include "AttitudeIndicator.h"
 #include <QPainter>
+#include <QtMath>
 #include <cmath>
+#include <cstring>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-AttitudeIndicator::AttitudeIndicator(QWidget *parent) : QWidget(parent)
+// Pixels per degree of pitch
+static const double pixels_per_degree = 1.5;
+// Logical extent of the horizon strip: +-90 deg of pitch plus the dial radius
+static const QRectF horizonStripRect(-100, -240, 200, 480);
+static const QRectF dialRect(-100, -100, 200, 200);
+
+AttitudeIndicator::AttitudeIndicator(QWidget *parent)
+    : InstrumentWidget(200.0, parent)
 {
     setMinimumSize(200, 200);
+    setChangeThreshold(0.1f); // degrees
 }
 
 void AttitudeIndicator::setRoll(float roll)
 {
-    m_roll_degrees = roll;
-    update();
+    setAttitude(roll, m_pitch_degrees);
 }
 
 void AttitudeIndicator::setPitch(float pitch)
 {
+    setAttitude(m_roll_degrees, pitch);
+}
+
+void AttitudeIndicator::setAttitude(float roll, float pitch)
+{
+    if (!exceedsThreshold(m_roll_degrees, roll) && !exceedsThreshold(m_pitch_degrees, pitch)) {
+        countSuppressedRepaint();
+        return;
+    }
+    m_roll_degrees = roll;
     m_pitch_degrees = pitch;
-    update();
+
+    // Only the horizon inside the bezel moves
+    updateLogicalRect(QRectF(-98, -98, 196, 196));
 }
 
-void AttitudeIndicator::paintEvent(QPaintEvent *event)
+void AttitudeIndicator::captureRenderState()
 {
-    Q_UNUSED(event);
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    m_render_roll_degrees = m_roll_degrees;
+    m_render_pitch_degrees = m_pitch_degrees;
+}
 
-    drawBackground(painter);
-    drawPitchAndRoll(painter);
-    drawFixedSymbol(painter);
+void AttitudeIndicator::staticLayersRebuilt()
+{
+    rebuildHorizonCache();
 }
 
-void AttitudeIndicator::drawBackground(QPainter &painter)
+void AttitudeIndicator::rebuildHorizonCache()
 {
-    int side = qMin(width(), height());
-    painter.save();
-    painter.translate(width() / 2.0, height() / 2.0);
-    painter.scale(side / 200.0, side / 200.0);
+    qreal scale = deviceScale();
+
+    m_horizon_strip = QImage(qCeil(horizonStripRect.width() * scale), qCeil(horizonStripRect.height() * scale),
+                             QImage::Format_ARGB32_Premultiplied);
+    m_horizon_strip.fill(Qt::transparent);
+    QPainter stripPainter(&m_horizon_strip);
+    stripPainter.setRenderHint(QPainter::Antialiasing);
+    stripPainter.scale(scale, scale);
+    stripPainter.translate(-horizonStripRect.left(), -horizonStripRect.top());
+    drawHorizonStrip(stripPainter);
+    stripPainter.end();
+
+    int dialPixels = qCeil(dialRect.width() * scale);
+    m_horizon_mask = QImage(dialPixels, dialPixels, QImage::Format_ARGB32_Premultiplied);
+    m_horizon_mask.fill(Qt::transparent);
+    QPainter maskPainter(&m_horizon_mask);
+    maskPainter.setRenderHint(QPainter::Antialiasing);
+    maskPainter.scale(scale, scale);
+    maskPainter.translate(-dialRect.left(), -dialRect.top());
+    maskPainter.setPen(Qt::NoPen);
+    maskPainter.setBrush(Qt::black);
+    maskPainter.drawEllipse(QPointF(0, 0), 98, 98);
+    maskPainter.end();
+
+    m_horizon_buffer = QImage(m_horizon_mask.size(), m_horizon_mask.format());
+}
 
+void AttitudeIndicator::drawStaticBackground(QPainter &painter)
+{
     // Outer circle
     painter.setPen(QPen(Qt::white, 2));
     painter.setBrush(Qt::black);
@@ -70,39 +115,52 @@ void AttitudeIndicator::drawBackground(QPainter &painter)
         }
         painter.restore();
     }
-    
-    // Restore painter state
-    painter.restore();
+}
+
+void AttitudeIndicator::drawDynamicLayer(QPainter &painter)
+{
+    drawPitchAndRoll(painter);
 }
 
 void AttitudeIndicator::drawPitchAndRoll(QPainter &painter)
 {
-    int side = qMin(width(), height());
-    painter.save();
-    painter.translate(width() / 2.0, height() / 2.0);
-    painter.scale(side / 200.0, side / 200.0);
-    
-    // Set clipping for the main circle
-    QRegion clipRegion(QRect(-98, -98, 196, 196), QRegion::Ellipse);
-    painter.setClipRegion(clipRegion);
+    if (m_horizon_buffer.isNull()) {
+        return;
+    }
+
+    // Reset the scratch image to the circular mask, then let SourceIn keep the
+    // strip only where the mask is opaque. This replaces an elliptical clip
+    // region and the per-frame ladder drawing with one transformed blit.
+    std::memcpy(m_horizon_buffer.bits(), m_horizon_mask.constBits(), m_horizon_mask.sizeInBytes());
 
-    // Rotate for roll
-    painter.rotate(m_roll_degrees);
+    QPainter bufferPainter(&m_horizon_buffer);
+    bufferPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    bufferPainter.setRenderHint(QPainter::SmoothPixmapTransform);
+    bufferPainter.translate(m_horizon_buffer.width() / 2.0, m_horizon_buffer.height() / 2.0);
+    bufferPainter.scale(deviceScale(), deviceScale());
 
-    // Translate for pitch
-    // Pixels per degree of pitch
-    const double pixels_per_degree = 1.5;
-    painter.translate(0, -m_pitch_degrees * pixels_per_degree);
+    // Rotate for roll, translate for pitch
+    bufferPainter.rotate(m_render_roll_degrees);
+    bufferPainter.translate(0, -m_render_pitch_degrees * pixels_per_degree);
+    bufferPainter.drawImage(horizonStripRect, m_horizon_strip);
+    bufferPainter.end();
+
+    painter.drawImage(dialRect, m_horizon_buffer);
+}
 
+void AttitudeIndicator::drawHorizonStrip(QPainter &painter)
+{
     // Sky and Ground
     QColor skyColor(50, 150, 250);
     QColor groundColor(140, 90, 40);
-    painter.fillRect(QRect(-200, -200, 400, 200), skyColor);
-    painter.fillRect(QRect(-200, 0, 400, 200), groundColor);
-    
+    QRectF sky(horizonStripRect.left(), horizonStripRect.top(), horizonStripRect.width(), -horizonStripRect.top());
+    QRectF ground(horizonStripRect.left(), 0, horizonStripRect.width(), horizonStripRect.bottom());
+    painter.fillRect(sky, skyColor);
+    painter.fillRect(ground, groundColor);
+
     // Horizon line
     painter.setPen(QPen(Qt::white, 2));
-    painter.drawLine(-200, 0, 200, 0);
+    painter.drawLine(QPointF(horizonStripRect.left(), 0), QPointF(horizonStripRect.right(), 0));
 
     // Pitch ladder
     painter.setPen(Qt::white);
@@ -118,17 +176,15 @@ void AttitudeIndicator::drawPitchAndRoll(QPainter &painter)
              painter.drawText(length / 2 + 5, y + 4, QString::number(i));
         }
     }
-    
-    painter.restore();
 }
 
-void AttitudeIndicator::drawFixedSymbol(QPainter &painter)
+bool AttitudeIndicator::hasStaticForeground() const
 {
-    int side = qMin(width(), height());
-    painter.save();
-    painter.translate(width() / 2.0, height() / 2.0);
-    painter.scale(side / 200.0, side / 200.0);
+    return true;
+}
 
+void AttitudeIndicator::drawStaticForeground(QPainter &painter)
+{
     painter.setPen(QPen(Qt::yellow, 2));
     painter.setBrush(Qt::NoBrush);
 
@@ -144,6 +200,4 @@ void AttitudeIndicator::drawFixedSymbol(QPainter &painter)
     triangle << QPointF(0, -98) << QPointF(-5, -88) << QPointF(5, -88);
     painter.setBrush(Qt::yellow);
     painter.drawPolygon(triangle);
-
-    painter.restore();
 } 
\ No newline at end of file
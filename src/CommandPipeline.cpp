@@ -0,0 +1,302 @@
+#include "CommandPipeline.h"
+#include <QMetaEnum>
+#include <algorithm>
+#include <chrono>
+#include <loguru.hpp>
+#include "LatencyStats.h"
+#include "Metrics.h"
+
+// Coalescing keys beyond the event IDs, for events that target the same thing
+static constexpr int key_gear = 100;
+static constexpr int key_flaps = 101;
+static constexpr int key_engine = 110; // + engine number
+
+static const char *eventName(TelemetrySource::EVENT_ID eventId)
+{
+    const char *name = QMetaEnum::fromType<TelemetrySource::EVENT_ID>().valueToKey(eventId);
+    return name ? name : "?";
+}
+
+CommandPipeline::CommandPipeline(TelemetrySource *source, QObject *parent)
+    : QObject(parent)
+    , m_source(source)
+{
+    m_worker = std::thread(&CommandPipeline::workerLoop, this);
+}
+
+CommandPipeline::~CommandPipeline()
+{
+    stop();
+}
+
+void CommandPipeline::stop()
+{
+    if (!m_worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+CommandPipeline::Kind CommandPipeline::kindFor(TelemetrySource::EVENT_ID eventId, quint32 data, int &key)
+{
+    switch (eventId) {
+    case TelemetrySource::EVENT_HEADING_BUG_SET:
+    case TelemetrySource::EVENT_AP_SPD_VAR_SET:
+    case TelemetrySource::EVENT_AP_ALT_VAR_SET:
+    case TelemetrySource::EVENT_AP_VS_VAR_SET:
+        key = eventId;
+        return Kind::Coalesce;
+    case TelemetrySource::EVENT_GEAR_UP:
+    case TelemetrySource::EVENT_GEAR_DOWN:
+        key = key_gear;
+        return Kind::Coalesce;
+    case TelemetrySource::EVENT_FLAPS_UP:
+    case TelemetrySource::EVENT_FLAPS_DOWN:
+        key = key_flaps;
+        return Kind::Coalesce;
+    case TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE2_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE3_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE4_STARTER:
+        key = key_engine + 1 + (eventId - TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER);
+        return Kind::Coalesce;
+    case TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN:
+        // The engine number travels as event data
+        key = key_engine + static_cast<int>(data);
+        return Kind::Coalesce;
+    default:
+        key = eventId;
+        return Kind::Toggle;
+    }
+}
+
+void CommandPipeline::submit(TelemetrySource::EVENT_ID eventId, quint32 data)
+{
+    Metrics &metrics = Metrics::instance();
+    metrics.commandsSubmitted.fetch_add(1, std::memory_order_relaxed);
+
+    int key = 0;
+    const Kind kind = kindFor(eventId, data, key);
+    const std::int64_t now = LatencyHistogram::now();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        KeyState &state = m_keys[key];
+        if (kind == Kind::Toggle) {
+            if (now < state.windowEnd) {
+                VLOG_F(1, "Rate limited %s", eventName(eventId));
+                metrics.commandsRateLimited.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            state.windowEnd = now + ToggleIntervalNs;
+            m_ready.push_back({ eventId, data, key });
+        } else if (!state.pending && now >= state.windowEnd) {
+            // Leading edge: nothing to coalesce with, send immediately
+            state.windowEnd = now + CoalesceWindowNs;
+            state.sent = true;
+            state.sentEventId = eventId;
+            state.sentData = data;
+            m_ready.push_back({ eventId, data, key });
+        } else if (state.sent && state.sentEventId == eventId && state.sentData == data) {
+            // Repeats what the window already sent, and supersedes anything
+            // pending in between
+            VLOG_F(1, "Dropped %s (%u), already sent", eventName(eventId), data);
+            metrics.commandsCoalesced.fetch_add(1, std::memory_order_relaxed);
+            state.pending = false;
+            return;
+        } else {
+            if (state.pending) {
+                VLOG_F(1, "Coalesced %s (%u) into %s (%u)", eventName(state.eventId), state.data, eventName(eventId), data);
+                metrics.commandsCoalesced.fetch_add(1, std::memory_order_relaxed);
+            }
+            state.pending = true;
+            state.eventId = eventId;
+            state.data = data;
+        }
+    }
+    m_wake.notify_one();
+}
+
+void CommandPipeline::observe(const AircraftData &data)
+{
+    std::vector<std::pair<TelemetrySource::EVENT_ID, qint64>> acknowledgedNow;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_latest = data;
+        m_has_latest = true;
+        if (m_acks.empty()) {
+            return;
+        }
+
+        const std::int64_t receivedNs = data.received_ns ? data.received_ns : LatencyHistogram::now();
+        for (auto it = m_acks.begin(); it != m_acks.end();) {
+            // Data that arrived before the command was sent cannot confirm it
+            if (receivedNs >= it->sentNs && satisfied(*it, data)) {
+                acknowledgedNow.emplace_back(it->eventId, receivedNs - it->sentNs);
+                it = m_acks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    Metrics &metrics = Metrics::instance();
+    for (const auto &ack : acknowledgedNow) {
+        VLOG_F(1, "%s acknowledged after %.1f ms", eventName(ack.first), ack.second / 1e6);
+        metrics.commandsAcknowledged.fetch_add(1, std::memory_order_relaxed);
+        LatencyStats::instance().commandAck.record(ack.second);
+        emit acknowledged(ack.first, ack.second);
+    }
+}
+
+void CommandPipeline::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ready.clear();
+    m_keys.clear();
+    m_acks.clear();
+    m_has_latest = false;
+}
+
+bool CommandPipeline::armAck(const Command &command, std::int64_t sentNs)
+{
+    // Called with the mutex held. Only events with a SimVar in the schema
+    // can be confirmed.
+    using namespace AircraftSchema;
+    Ack ack { command.eventId, command.key, FieldId(0), Test::Equals, 0.0, sentNs, sentNs + AckTimeoutNs };
+    switch (command.eventId) {
+    case TelemetrySource::EVENT_GEAR_UP:
+    case TelemetrySource::EVENT_GEAR_DOWN:
+        ack.field = gear_handle_position;
+        ack.reference = command.eventId == TelemetrySource::EVENT_GEAR_DOWN ? 1.0 : 0.0;
+        break;
+    case TelemetrySource::EVENT_PARKING_BRAKES:
+        ack.field = parking_brake_position;
+        ack.test = Test::Differs;
+        break;
+    case TelemetrySource::EVENT_AP_MASTER:
+        ack.field = autopilot_master;
+        ack.test = Test::Differs;
+        break;
+    case TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE2_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE3_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE4_STARTER:
+        ack.field = FieldId(eng_n1_1 + (command.eventId - TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER));
+        ack.test = Test::Rises;
+        break;
+    case TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN:
+        if (command.data < 1 || command.data > 4) {
+            return false;
+        }
+        ack.field = FieldId(eng_n1_1 + command.data - 1);
+        ack.test = Test::Falls;
+        break;
+    default:
+        return false;
+    }
+
+    if (ack.test == Test::Equals) {
+        // Already in the requested state: nothing to confirm
+        if (m_has_latest && value(m_latest, ack.field) == ack.reference) {
+            return false;
+        }
+    } else if (m_has_latest) {
+        ack.reference = value(m_latest, ack.field);
+    } else {
+        return false;
+    }
+
+    // A newer command for the same target supersedes the outstanding one
+    m_acks.erase(std::remove_if(m_acks.begin(), m_acks.end(), [&](const Ack &other) { return other.key == ack.key; }),
+                 m_acks.end());
+    m_acks.push_back(ack);
+    return true;
+}
+
+bool CommandPipeline::satisfied(const Ack &ack, const AircraftData &data)
+{
+    // N1 has to move by more than its usual jitter
+    constexpr double n1_change = 1.0;
+    const double current = AircraftSchema::value(data, ack.field);
+    switch (ack.test) {
+    case Test::Equals: return current == ack.reference;
+    case Test::Differs: return current != ack.reference;
+    case Test::Rises: return current >= ack.reference + n1_change;
+    case Test::Falls: return current <= ack.reference - n1_change;
+    }
+    return false;
+}
+
+void CommandPipeline::workerLoop()
+{
+    loguru::set_thread_name("CommandPipeline");
+    Metrics &metrics = Metrics::instance();
+    std::vector<Command> sending;
+    std::vector<TelemetrySource::EVENT_ID> expired;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        const std::int64_t now = LatencyHistogram::now();
+
+        // Windows that closed with a coalesced command waiting
+        std::int64_t nextDeadline = INT64_MAX;
+        for (auto &entry : m_keys) {
+            KeyState &state = entry.second;
+            if (!state.pending) {
+                continue;
+            }
+            if (now >= state.windowEnd) {
+                m_ready.push_back({ state.eventId, state.data, entry.first });
+                state.pending = false;
+                state.sentEventId = state.eventId;
+                state.sentData = state.data;
+                state.windowEnd = now + CoalesceWindowNs;
+            } else {
+                nextDeadline = std::min(nextDeadline, state.windowEnd);
+            }
+        }
+
+        for (auto it = m_acks.begin(); it != m_acks.end();) {
+            if (now >= it->deadlineNs) {
+                expired.push_back(it->eventId);
+                it = m_acks.erase(it);
+            } else {
+                nextDeadline = std::min(nextDeadline, it->deadlineNs);
+                ++it;
+            }
+        }
+
+        sending.swap(m_ready);
+        for (const Command &command : sending) {
+            armAck(command, now);
+        }
+        if (!sending.empty() || !expired.empty()) {
+            lock.unlock();
+            for (const Command &command : sending) {
+                VLOG_F(1, "Sending %s (%u)", eventName(command.eventId), command.data);
+                m_source->transmitEvent(command.eventId, command.data);
+            }
+            for (TelemetrySource::EVENT_ID eventId : expired) {
+                LOG_F(WARNING, "%s not acknowledged by the sim within %lld ms", eventName(eventId),
+                      static_cast<long long>(AckTimeoutNs / 1000000));
+                metrics.commandsTimedOut.fetch_add(1, std::memory_order_relaxed);
+                emit timedOut(eventId);
+            }
+            sending.clear();
+            expired.clear();
+            lock.lock();
+            continue;
+        }
+
+        if (nextDeadline == INT64_MAX) {
+            m_wake.wait(lock);
+        } else {
+            m_wake.wait_for(lock, std::chrono::nanoseconds(nextDeadline - now));
+        }
+    }
+}
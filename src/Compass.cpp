@@ -6,41 +6,86 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-Compass::Compass(QWidget *parent) : QWidget(parent)
+static const QRectF headingBoxRect(-25, -45, 50, 20);
+
+Compass::Compass(QWidget *parent)
+    : InstrumentWidget(200.0, parent)
+    , m_heading_readout(QFont("Arial", 10, QFont::Bold), Qt::white)
 {
     setMinimumSize(200, 200);
+    setChangeThreshold(0.1f); // degrees
+}
+
+static int displayedHeading(float heading)
+{
+    return static_cast<int>(std::lround(fmod(heading, 360)));
 }
 
 void Compass::setHeading(float heading)
 {
-    m_heading_degrees = heading;
-    update();
+    if (exceedsThreshold(m_heading_degrees, heading)) {
+        // The card rotates, which touches the whole dial
+        m_heading_degrees = heading;
+        updateLogicalRect(QRectF(-100, -100, 200, 200));
+    } else if (displayedHeading(heading) != displayedHeading(m_heading_degrees)) {
+        // Sub-threshold change that still flips the readout
+        m_heading_degrees = heading;
+        updateLogicalRect(headingBoxRect);
+    } else {
+        countSuppressedRepaint();
+    }
 }
 
-void Compass::paintEvent(QPaintEvent *event)
+void Compass::captureRenderState()
 {
-    Q_UNUSED(event);
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-    drawCompass(painter);
+    m_render_heading_degrees = m_heading_degrees;
 }
 
-void Compass::drawCompass(QPainter &painter)
+void Compass::staticLayersRebuilt()
 {
-    int side = qMin(width(), height());
-    painter.save();
-    painter.translate(width() / 2.0, height() / 2.0);
-    painter.scale(side / 200.0, side / 200.0);
+    // The card only ever rotates, so it is rendered once and blitted rotated.
+    m_card_layer = renderLayer([this](QPainter &painter) { drawCompassCard(painter); });
+    m_heading_readout.rebuild(deviceScale());
+}
 
+void Compass::drawStaticBackground(QPainter &painter)
+{
     // Outer circle
     painter.setPen(QPen(Qt::white, 2));
     painter.setBrush(Qt::black);
     painter.drawEllipse(QPointF(0, 0), 98, 98);
 
-    painter.save();
-    // Rotate the painter to the current heading
-    painter.rotate(m_heading_degrees);
+    // Fixed airplane icon in the center
+    painter.setPen(QPen(Qt::yellow, 1));
+    painter.setBrush(Qt::yellow);
+    QPolygonF airplane;
+    airplane << QPointF(0, -18);   // Nose
+    airplane << QPointF(2, -10);
+    airplane << QPointF(12, -5);  // Right wing tip
+    airplane << QPointF(12, 0);
+    airplane << QPointF(2, 0);
+    airplane << QPointF(2, 12);
+    airplane << QPointF(6, 17);   // Right tail tip
+    airplane << QPointF(4, 17);
+    airplane << QPointF(0, 15);   // Tail center
+    airplane << QPointF(-4, 17);
+    airplane << QPointF(-6, 17);  // Left tail tip
+    airplane << QPointF(-2, 12);
+    airplane << QPointF(-2, 0);
+    airplane << QPointF(-12, 0);
+    airplane << QPointF(-12, -5); // Left wing tip
+    airplane << QPointF(-2, -10);
+    painter.drawPolygon(airplane);
 
+    // Heading box above the airplane; it never overlaps the card, so it can
+    // live in the background and the value is drawn on top of it per frame.
+    painter.setPen(QPen(Qt::white, 1));
+    painter.setBrush(QColor(20, 20, 20, 180)); // Semi-transparent dark gray
+    painter.drawRoundedRect(headingBoxRect, 5, 5);
+}
+
+void Compass::drawCompassCard(QPainter &painter)
+{
     // Markings
     painter.setPen(Qt::white);
     for (int i = 0; i < 360; i += 10) {
@@ -66,47 +111,35 @@ void Compass::drawCompass(QPainter &painter)
         }
         painter.restore();
     }
+}
+
+void Compass::drawDynamicLayer(QPainter &painter)
+{
+    // Rotate the cached card to the current heading
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.rotate(m_render_heading_degrees);
+    qreal half = logicalSize() / 2.0;
+    painter.drawImage(QRectF(-half, -half, logicalSize(), logicalSize()), m_card_layer, QRectF(m_card_layer.rect()));
     painter.restore();
-    
+
+    // Heading value inside the box drawn by the background layer
+    char headingText[8];
+    int length = ReadoutRenderer::formatFixed(headingText, sizeof(headingText), fmod(m_render_heading_degrees, 360), 0, 3);
+    m_heading_readout.draw(painter, headingBoxRect, Qt::AlignCenter, headingText, length);
+}
+
+bool Compass::hasStaticForeground() const
+{
+    return true;
+}
+
+void Compass::drawStaticForeground(QPainter &painter)
+{
     // Fixed lubber line at the top
     painter.setPen(QPen(Qt::white, 1));
     painter.setBrush(Qt::white);
     QPolygonF lubber;
     lubber << QPointF(0, -98) << QPointF(-5, -88) << QPointF(5, -88);
     painter.drawPolygon(lubber);
-
-    // Fixed airplane icon in the center
-    painter.setPen(QPen(Qt::yellow, 1));
-    painter.setBrush(Qt::yellow);
-    QPolygonF airplane;
-    airplane << QPointF(0, -18);   // Nose
-    airplane << QPointF(2, -10);
-    airplane << QPointF(12, -5);  // Right wing tip
-    airplane << QPointF(12, 0);
-    airplane << QPointF(2, 0);
-    airplane << QPointF(2, 12);
-    airplane << QPointF(6, 17);   // Right tail tip
-    airplane << QPointF(4, 17);
-    airplane << QPointF(0, 15);   // Tail center
-    airplane << QPointF(-4, 17);
-    airplane << QPointF(-6, 17);  // Left tail tip
-    airplane << QPointF(-2, 12);
-    airplane << QPointF(-2, 0);
-    airplane << QPointF(-12, 0);
-    airplane << QPointF(-12, -5); // Left wing tip
-    airplane << QPointF(-2, -10);
-    painter.drawPolygon(airplane);
-    
-    // Display heading value in a professional-looking box above the airplane
-    QRectF headingRect(-25, -45, 50, 20);
-    painter.setPen(QPen(Qt::white, 1));
-    painter.setBrush(QColor(20, 20, 20, 180)); // Semi-transparent dark gray
-    painter.drawRoundedRect(headingRect, 5, 5);
-    
-    painter.setPen(Qt::white);
-    painter.setFont(QFont("Arial", 10, QFont::Bold));
-    QString headingText = QString::asprintf("%03.0f", fmod(m_heading_degrees, 360));
-    painter.drawText(headingRect, Qt::AlignCenter, headingText);
-
-    painter.restore();
-} 
\ No newline at end of file
+}
@@ -0,0 +1,27 @@
+#include "DashboardApplication.h"
+#include "Trace.h"
+
+DashboardApplication::DashboardApplication(int &argc, char **argv)
+    : QApplication(argc, argv)
+{
+}
+
+bool DashboardApplication::notify(QObject *receiver, QEvent *event)
+{
+    if (Trace::enabled()) {
+        switch (event->type()) {
+        case QEvent::LayoutRequest: {
+            TRACE_SCOPE("LayoutRequest");
+            return QApplication::notify(receiver, event);
+        }
+        case QEvent::UpdateRequest: {
+            // Repaints all dirty widgets of the window and flushes the backing store
+            TRACE_SCOPE("UpdateRequest");
+            return QApplication::notify(receiver, event);
+        }
+        default:
+            break;
+        }
+    }
+    return QApplication::notify(receiver, event);
+}
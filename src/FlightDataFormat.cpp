@@ -0,0 +1,484 @@
+#include "FlightDataFormat.h"
+#include <cmath>
+#include <cstring>
+
+namespace FlightData {
+
+const std::vector<Channel> &aircraftChannels()
+{
+    // One channel per schema field. Flags are stored losslessly; continuous
+    // values are quantized to a tenth of the SimConnect epsilon, which is
+    // already below anything the dashboard can display.
+    static const std::vector<Channel> channels = [] {
+        std::vector<Channel> result;
+        for (const AircraftSchema::Field &field : AircraftSchema::Fields) {
+            if (field.isInteger) {
+                result.push_back({ field.name, Codec::Xor, 0.0 });
+            } else {
+                result.push_back({ field.name, Codec::QuantizedDelta, field.epsilon * 0.1 });
+            }
+        }
+        return result;
+    }();
+    return channels;
+}
+
+void toChannels(const AircraftData &data, double *values)
+{
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        values[i] = AircraftSchema::value(data, i);
+    }
+}
+
+void fromChannels(const double *values, AircraftData &data)
+{
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        AircraftSchema::setValue(data, i, values[i]);
+    }
+}
+
+// --- Bit I/O -----------------------------------------------------------------
+
+void BitWriter::write(std::uint64_t value, int bits)
+{
+    // Emit most significant bits first, at most 32 at a time
+    while (bits > 0) {
+        int take = bits > 32 ? 32 : bits;
+        bits -= take;
+        std::uint64_t part = (value >> bits) & ((1ULL << take) - 1);
+        m_buffer = (m_buffer << take) | part;
+        m_buffered += take;
+        while (m_buffered >= 8) {
+            m_buffered -= 8;
+            m_out.push_back(static_cast<std::uint8_t>(m_buffer >> m_buffered));
+        }
+    }
+}
+
+void BitWriter::flush()
+{
+    if (m_buffered > 0) {
+        m_out.push_back(static_cast<std::uint8_t>(m_buffer << (8 - m_buffered)));
+        m_buffered = 0;
+    }
+    m_buffer = 0;
+}
+
+std::uint64_t BitReader::read(int bits)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < bits; ++i) {
+        std::size_t byte = m_bit >> 3;
+        if (byte >= m_size) {
+            m_overrun = true;
+            return value;
+        }
+        int shift = 7 - static_cast<int>(m_bit & 7);
+        value = (value << 1) | ((m_data[byte] >> shift) & 1);
+        ++m_bit;
+    }
+    return value;
+}
+
+// --- Little endian helpers -----------------------------------------------------
+
+template <typename T>
+static void put(std::vector<std::uint8_t> &out, T value)
+{
+    // The dashboard only targets little-endian hosts (x86-64, ARM64)
+    std::uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool get(const std::uint8_t *data, std::size_t size, std::size_t &offset, T &value)
+{
+    if (offset > size || sizeof(T) > size - offset) {
+        return false;
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+template <typename T>
+static void patch(std::vector<std::uint8_t> &out, std::size_t offset, T value)
+{
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+// --- Column codecs ------------------------------------------------------------
+
+static std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Delta-of-delta buckets: '0', '10'+7, '110'+12, '1110'+20, '1111'+64 bits
+static void writeDeltaOfDelta(BitWriter &writer, std::int64_t dod)
+{
+    std::uint64_t encoded = zigzag(dod);
+    if (encoded == 0) {
+        writer.write(0b0, 1);
+    } else if (encoded < (1ULL << 7)) {
+        writer.write(0b10, 2);
+        writer.write(encoded, 7);
+    } else if (encoded < (1ULL << 12)) {
+        writer.write(0b110, 3);
+        writer.write(encoded, 12);
+    } else if (encoded < (1ULL << 20)) {
+        writer.write(0b1110, 4);
+        writer.write(encoded, 20);
+    } else {
+        writer.write(0b1111, 4);
+        writer.write(encoded, 64);
+    }
+}
+
+static std::int64_t readDeltaOfDelta(BitReader &reader)
+{
+    if (!reader.readBit()) return 0;
+    if (!reader.readBit()) return unzigzag(reader.read(7));
+    if (!reader.readBit()) return unzigzag(reader.read(12));
+    if (!reader.readBit()) return unzigzag(reader.read(20));
+    return unzigzag(reader.read(64));
+}
+
+// Deltas are taken modulo 2^64, so any input round-trips and a corrupt
+// file cannot overflow a signed integer while decoding.
+static void encodeIntegers(const std::int64_t *values, std::size_t count, std::size_t stride, std::vector<std::uint8_t> &out)
+{
+    BitWriter writer(out);
+    std::uint64_t previous = 0;
+    std::uint64_t previousDelta = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t value = static_cast<std::uint64_t>(values[i * stride]);
+        std::uint64_t delta = value - previous;
+        writeDeltaOfDelta(writer, static_cast<std::int64_t>(delta - previousDelta));
+        previous = value;
+        previousDelta = delta;
+    }
+}
+
+static void decodeIntegers(BitReader &reader, std::size_t count, std::int64_t *values, std::size_t stride)
+{
+    std::uint64_t previous = 0;
+    std::uint64_t previousDelta = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t delta = previousDelta + static_cast<std::uint64_t>(readDeltaOfDelta(reader));
+        previous += delta;
+        previousDelta = delta;
+        values[i * stride] = static_cast<std::int64_t>(previous);
+    }
+}
+
+// Quantized values are clamped to +-2^52 steps, which keeps them exact in a
+// double. Non-finite samples cannot be quantized: NaN is stored as zero and
+// infinities as the clamp limit.
+static constexpr double quantized_limit = 4503599627370496.0;
+
+static std::int64_t quantize(double value, double resolution)
+{
+    if (std::isnan(value)) {
+        return 0;
+    }
+    const double steps = value / resolution;
+    if (steps >= quantized_limit) {
+        return static_cast<std::int64_t>(quantized_limit);
+    }
+    if (steps <= -quantized_limit) {
+        return -static_cast<std::int64_t>(quantized_limit);
+    }
+    return std::llround(steps);
+}
+
+// A QuantizedDelta channel without a usable resolution is stored losslessly
+// instead. readFileHeader rejects such channels, so this only affects
+// channel tables built in code.
+static bool isQuantized(const Channel &channel)
+{
+    return channel.codec == Codec::QuantizedDelta && std::isfinite(channel.resolution) && channel.resolution > 0.0;
+}
+
+static int countLeadingZeros(std::uint64_t value)
+{
+    int count = 0;
+    for (std::uint64_t mask = 1ULL << 63; mask && !(value & mask); mask >>= 1) ++count;
+    return count;
+}
+
+static int countTrailingZeros(std::uint64_t value)
+{
+    int count = 0;
+    for (std::uint64_t mask = 1; mask && !(value & mask); mask <<= 1) ++count;
+    return count;
+}
+
+static void encodeXor(const double *values, std::size_t count, std::size_t stride, std::vector<std::uint8_t> &out)
+{
+    BitWriter writer(out);
+    std::uint64_t previous = 0;
+    int previousLeading = -1;
+    int previousTrailing = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &values[i * stride], sizeof(bits));
+        if (i == 0) {
+            writer.write(bits, 64);
+            previous = bits;
+            continue;
+        }
+
+        std::uint64_t x = bits ^ previous;
+        previous = bits;
+        if (x == 0) {
+            writer.writeBit(false);
+            continue;
+        }
+        writer.writeBit(true);
+
+        int leading = countLeadingZeros(x);
+        int trailing = countTrailingZeros(x);
+        if (leading > 31) leading = 31; // 5-bit field
+        if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing) {
+            // Fits in the previous window
+            writer.writeBit(false);
+            int meaningful = 64 - previousLeading - previousTrailing;
+            writer.write(x >> previousTrailing, meaningful);
+        } else {
+            int meaningful = 64 - leading - trailing;
+            writer.writeBit(true);
+            writer.write(static_cast<std::uint64_t>(leading), 5);
+            writer.write(static_cast<std::uint64_t>(meaningful - 1), 6);
+            writer.write(x >> trailing, meaningful);
+            previousLeading = leading;
+            previousTrailing = trailing;
+        }
+    }
+}
+
+static void decodeXor(BitReader &reader, std::size_t count, double *values, std::size_t stride)
+{
+    std::uint64_t previous = 0;
+    int previousLeading = 0;
+    int previousTrailing = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            previous = reader.read(64);
+        } else if (reader.readBit()) {
+            if (reader.readBit()) {
+                previousLeading = static_cast<int>(reader.read(5));
+                int meaningful = static_cast<int>(reader.read(6)) + 1;
+                previousTrailing = 64 - previousLeading - meaningful;
+            }
+            int meaningful = 64 - previousLeading - previousTrailing;
+            previous ^= reader.read(meaningful) << previousTrailing;
+        }
+        std::memcpy(&values[i * stride], &previous, sizeof(previous));
+    }
+}
+
+// --- File and chunk layout ----------------------------------------------------
+
+void writeFileHeader(const FileHeader &header, std::vector<std::uint8_t> &out)
+{
+    out.insert(out.end(), FileMagic, FileMagic + sizeof(FileMagic));
+    put<std::uint32_t>(out, header.version);
+    put<std::uint32_t>(out, header.chunkCapacity);
+    put<std::int64_t>(out, header.startUnixMicroseconds);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(header.channels.size()));
+    for (const Channel &channel : header.channels) {
+        put<std::uint16_t>(out, static_cast<std::uint16_t>(channel.name.size()));
+        out.insert(out.end(), channel.name.begin(), channel.name.end());
+        put<std::uint8_t>(out, static_cast<std::uint8_t>(channel.codec));
+        put<double>(out, channel.resolution);
+    }
+}
+
+std::size_t readFileHeader(const std::uint8_t *data, std::size_t size, FileHeader &header)
+{
+    if (size < sizeof(FileMagic) || std::memcmp(data, FileMagic, sizeof(FileMagic)) != 0) {
+        return 0;
+    }
+
+    std::size_t offset = sizeof(FileMagic);
+    std::uint32_t channelCount = 0;
+    if (!get(data, size, offset, header.version) || header.version != FormatVersion
+        || !get(data, size, offset, header.chunkCapacity)
+        || !get(data, size, offset, header.startUnixMicroseconds)
+        || !get(data, size, offset, channelCount)) {
+        return 0;
+    }
+
+    header.channels.clear();
+    for (std::uint32_t i = 0; i < channelCount; ++i) {
+        std::uint16_t nameLength = 0;
+        if (!get(data, size, offset, nameLength) || nameLength > size - offset) {
+            return 0;
+        }
+        Channel channel;
+        channel.name.assign(reinterpret_cast<const char *>(data + offset), nameLength);
+        offset += nameLength;
+        std::uint8_t codec = 0;
+        if (!get(data, size, offset, codec) || !get(data, size, offset, channel.resolution)
+            || codec > static_cast<std::uint8_t>(Codec::QuantizedDelta)) {
+            return 0;
+        }
+        channel.codec = static_cast<Codec>(codec);
+        if (channel.codec == Codec::QuantizedDelta && !isQuantized(channel)) {
+            return 0;
+        }
+        header.channels.push_back(channel);
+    }
+    return offset;
+}
+
+void encodeChunk(const std::int64_t *timestamps, const double *values, std::size_t count,
+                 const std::vector<Channel> &channels, std::vector<std::uint8_t> &out)
+{
+    const std::size_t channelCount = channels.size();
+    const std::size_t chunkStart = out.size();
+
+    put<std::uint32_t>(out, ChunkMagic);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(count));
+    put<std::int64_t>(out, count ? timestamps[0] : 0);
+    put<std::int64_t>(out, count ? timestamps[count - 1] : 0);
+    put<std::uint32_t>(out, 0); // payload size, patched below
+
+    // Column size table, patched as columns are written
+    const std::size_t sizeTable = out.size();
+    out.resize(out.size() + (channelCount + 1) * sizeof(std::uint32_t));
+
+    std::size_t columnStart = out.size();
+    encodeIntegers(timestamps, count, 1, out);
+    patch<std::uint32_t>(out, sizeTable, static_cast<std::uint32_t>(out.size() - columnStart));
+
+    std::vector<std::int64_t> quantized(count);
+    for (std::size_t c = 0; c < channelCount; ++c) {
+        columnStart = out.size();
+        if (isQuantized(channels[c])) {
+            for (std::size_t i = 0; i < count; ++i) {
+                quantized[i] = quantize(values[i * channelCount + c], channels[c].resolution);
+            }
+            encodeIntegers(quantized.data(), count, 1, out);
+        } else {
+            encodeXor(values + c, count, channelCount, out);
+        }
+        patch<std::uint32_t>(out, sizeTable + (c + 1) * sizeof(std::uint32_t),
+                             static_cast<std::uint32_t>(out.size() - columnStart));
+    }
+
+    patch<std::uint32_t>(out, chunkStart + ChunkHeaderSize - sizeof(std::uint32_t),
+                         static_cast<std::uint32_t>(out.size() - chunkStart - ChunkHeaderSize));
+}
+
+bool readChunkHeader(const std::uint8_t *data, std::size_t size, ChunkHeader &header)
+{
+    std::size_t offset = 0;
+    std::uint32_t magic = 0;
+    return get(data, size, offset, magic) && magic == ChunkMagic
+        && get(data, size, offset, header.sampleCount)
+        && get(data, size, offset, header.firstTimestamp)
+        && get(data, size, offset, header.lastTimestamp)
+        && get(data, size, offset, header.payloadSize);
+}
+
+bool decodeChunkPayload(const std::uint8_t *payload, std::size_t size, const ChunkHeader &header,
+                        const std::vector<Channel> &channels,
+                        std::vector<std::int64_t> &timestamps, std::vector<double> &values)
+{
+    const std::size_t count = header.sampleCount;
+    const std::size_t channelCount = channels.size();
+    // The count comes from the file: every column spends at least one bit
+    // per sample, so a payload this small cannot hold more
+    std::size_t offset = (channelCount + 1) * sizeof(std::uint32_t);
+    if (count == 0 || offset > size
+        || static_cast<std::uint64_t>(count) * (channelCount + 1) > static_cast<std::uint64_t>(size - offset) * 8) {
+        return false;
+    }
+    timestamps.resize(count);
+    values.resize(count * channelCount);
+
+    std::vector<std::int64_t> quantized(count);
+    for (std::size_t column = 0; column <= channelCount; ++column) {
+        std::uint32_t columnSize = 0;
+        std::memcpy(&columnSize, payload + column * sizeof(std::uint32_t), sizeof(columnSize));
+        if (columnSize > size - offset) {
+            return false;
+        }
+
+        BitReader reader(payload + offset, columnSize);
+        if (column == 0) {
+            decodeIntegers(reader, count, timestamps.data(), 1);
+        } else {
+            const Channel &channel = channels[column - 1];
+            if (isQuantized(channel)) {
+                decodeIntegers(reader, count, quantized.data(), 1);
+                for (std::size_t i = 0; i < count; ++i) {
+                    values[i * channelCount + column - 1] = quantized[i] * channel.resolution;
+                }
+            } else {
+                decodeXor(reader, count, values.data() + column - 1, channelCount);
+            }
+        }
+        if (reader.overrun()) {
+            return false;
+        }
+        offset += columnSize;
+    }
+    return true;
+}
+
+void writeIndex(const std::vector<IndexEntry> &entries, std::uint64_t indexOffset, std::vector<std::uint8_t> &out)
+{
+    for (const IndexEntry &entry : entries) {
+        put<std::int64_t>(out, entry.firstTimestamp);
+        put<std::int64_t>(out, entry.lastTimestamp);
+        put<std::uint64_t>(out, entry.offset);
+        put<std::uint32_t>(out, entry.sampleCount);
+    }
+    put<std::uint64_t>(out, indexOffset);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(entries.size()));
+    out.insert(out.end(), IndexMagic, IndexMagic + sizeof(IndexMagic));
+}
+
+bool readIndex(const std::uint8_t *data, std::size_t size, std::vector<IndexEntry> &entries)
+{
+    if (size < IndexTrailerSize
+        || std::memcmp(data + size - sizeof(IndexMagic), IndexMagic, sizeof(IndexMagic)) != 0) {
+        return false;
+    }
+
+    // The index fills the bytes between indexOffset and the trailer exactly;
+    // checked without sums that could wrap on a corrupt trailer
+    const std::size_t indexEnd = size - IndexTrailerSize;
+    std::size_t offset = indexEnd;
+    std::uint64_t indexOffset = 0;
+    std::uint32_t entryCount = 0;
+    if (!get(data, size, offset, indexOffset) || !get(data, size, offset, entryCount)
+        || indexOffset > indexEnd || entryCount > (indexEnd - indexOffset) / IndexEntrySize
+        || (indexEnd - indexOffset) != static_cast<std::uint64_t>(entryCount) * IndexEntrySize) {
+        return false;
+    }
+
+    entries.resize(entryCount);
+    offset = static_cast<std::size_t>(indexOffset);
+    for (IndexEntry &entry : entries) {
+        if (!get(data, size, offset, entry.firstTimestamp)
+            || !get(data, size, offset, entry.lastTimestamp)
+            || !get(data, size, offset, entry.offset)
+            || !get(data, size, offset, entry.sampleCount)) {
+            entries.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace FlightData
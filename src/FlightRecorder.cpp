@@ -0,0 +1,176 @@
+#include "FlightRecorder.h"
+#include <QDateTime>
+#include <QFile>
+#include <algorithm>
+#include <loguru.hpp>
+#include "LatencyHistogram.h"
+
+static constexpr std::size_t file_buffer_size = 1 << 20;
+
+FlightRecorder::FlightRecorder(QObject *parent)
+    : QObject(parent)
+    , m_channels(FlightData::aircraftChannels())
+{
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    stop();
+}
+
+bool FlightRecorder::start(const QString &path)
+{
+    if (m_file) {
+        LOG_F(WARNING, "Flight recorder already running");
+        return false;
+    }
+
+    m_file = std::fopen(QFile::encodeName(path).constData(), "wb");
+    if (!m_file) {
+        LOG_F(ERROR, "Failed to open flight recording %s", qPrintable(path));
+        return false;
+    }
+    m_file_buffer.resize(file_buffer_size);
+    std::setvbuf(m_file, m_file_buffer.data(), _IOFBF, m_file_buffer.size());
+
+    FlightData::FileHeader header;
+    header.startUnixMicroseconds = QDateTime::currentMSecsSinceEpoch() * 1000;
+    header.channels = m_channels;
+    std::vector<std::uint8_t> bytes;
+    FlightData::writeFileHeader(header, bytes);
+    std::fwrite(bytes.data(), 1, bytes.size(), m_file);
+
+    m_stopping = false;
+    m_index.clear();
+    m_file_offset = bytes.size();
+    m_writer = std::thread(&FlightRecorder::writerLoop, this);
+    {
+        std::lock_guard<std::mutex> lock(m_append_mutex);
+        m_samples.store(0, std::memory_order_relaxed);
+        m_current = takeFreeChunk();
+        m_start_ns = LatencyHistogram::now();
+        m_recording.store(true, std::memory_order_release);
+    }
+
+    LOG_F(INFO, "Recording flight to %s", qPrintable(path));
+    return true;
+}
+
+void FlightRecorder::stop()
+{
+    if (!m_file) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_append_mutex);
+        m_recording.store(false, std::memory_order_release);
+        if (m_current && m_current->count > 0) {
+            submitCurrentChunk();
+        }
+        m_current.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+
+    std::fclose(m_file);
+    m_file = nullptr;
+    LOG_F(INFO, "Flight recording stopped after %llu samples", samplesRecorded());
+}
+
+void FlightRecorder::append(const AircraftData &data)
+{
+    if (!m_recording.load(std::memory_order_acquire)) {
+        return;
+    }
+    // Only contended while starting or stopping
+    std::lock_guard<std::mutex> lock(m_append_mutex);
+    if (!m_current) {
+        return;
+    }
+
+    // Stamped with the receive time so replays keep the real arrival pattern
+    const std::int64_t receivedNs = data.received_ns ? data.received_ns : LatencyHistogram::now();
+    Chunk &chunk = *m_current;
+    chunk.timestamps[chunk.count] = std::max<std::int64_t>(0, receivedNs - m_start_ns) / 1000;
+    FlightData::toChannels(data, &chunk.values[chunk.count * m_channels.size()]);
+    ++chunk.count;
+    m_samples.fetch_add(1, std::memory_order_relaxed);
+
+    if (chunk.count == chunk.timestamps.size()) {
+        submitCurrentChunk();
+    }
+}
+
+std::unique_ptr<FlightRecorder::Chunk> FlightRecorder::takeFreeChunk()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty()) {
+            std::unique_ptr<Chunk> chunk = std::move(m_free.back());
+            m_free.pop_back();
+            chunk->count = 0;
+            return chunk;
+        }
+    }
+
+    auto chunk = std::make_unique<Chunk>();
+    chunk->timestamps.resize(FlightData::DefaultChunkCapacity);
+    chunk->values.resize(FlightData::DefaultChunkCapacity * m_channels.size());
+    return chunk;
+}
+
+void FlightRecorder::submitCurrentChunk()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(std::move(m_current));
+    }
+    m_wake.notify_one();
+    m_current = takeFreeChunk();
+}
+
+void FlightRecorder::writerLoop()
+{
+    loguru::set_thread_name("FlightRecorder");
+    std::vector<std::uint8_t> bytes;
+
+    for (;;) {
+        std::unique_ptr<Chunk> chunk;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+            if (m_pending.empty()) {
+                break; // stopping and drained
+            }
+            chunk = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+
+        bytes.clear();
+        FlightData::encodeChunk(chunk->timestamps.data(), chunk->values.data(), chunk->count, m_channels, bytes);
+        if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size()) {
+            LOG_F(ERROR, "Failed to write flight recording chunk");
+        }
+
+        FlightData::IndexEntry entry;
+        entry.firstTimestamp = chunk->timestamps[0];
+        entry.lastTimestamp = chunk->timestamps[chunk->count - 1];
+        entry.offset = m_file_offset;
+        entry.sampleCount = static_cast<std::uint32_t>(chunk->count);
+        m_index.push_back(entry);
+        m_file_offset += bytes.size();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(std::move(chunk));
+    }
+
+    bytes.clear();
+    FlightData::writeIndex(m_index, m_file_offset, bytes);
+    std::fwrite(bytes.data(), 1, bytes.size(), m_file);
+    std::fflush(m_file);
+}
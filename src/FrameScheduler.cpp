@@ -0,0 +1,126 @@
+#include "FrameScheduler.h"
+#include <QScreen>
+#include <QWindow>
+#include <loguru.hpp>
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+
+FrameScheduler::FrameScheduler(QWidget *window, QObject *parent)
+    : QObject(parent)
+    , m_window(window)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &FrameScheduler::onTick);
+    m_clock.start();
+    updateRefreshRate();
+}
+
+void FrameScheduler::submit(const AircraftData &data)
+{
+    m_latest = data;
+    m_predictor.addSample(data);
+    ++m_pending_frames;
+    ++m_sim_frames;
+    m_idle_ticks = 0;
+    Metrics::instance().simFrames.fetch_add(1, std::memory_order_relaxed);
+
+    if (!m_timer.isActive()) {
+        updateRefreshRate();
+        m_next_deadline_ns = m_clock.nsecsElapsed();
+        scheduleNextTick();
+    }
+}
+
+void FrameScheduler::reset()
+{
+    m_timer.stop();
+    m_pending_frames = 0;
+    m_idle_ticks = 0;
+    m_showing_prediction = false;
+    m_predictor.reset();
+}
+
+void FrameScheduler::onTick()
+{
+    // What is drawn now is presented at the next vsync
+    const qint64 displayTime = LatencyHistogram::now() + m_frame_interval_ns;
+    const bool predicting = m_predictor.isActive(displayTime);
+
+    if (m_pending_frames > 0) {
+        m_last_frames_per_display = m_pending_frames;
+        m_max_frames_per_display = qMax(m_max_frames_per_display, m_pending_frames);
+        Metrics &metrics = Metrics::instance();
+        metrics.displayedFrames.fetch_add(1, std::memory_order_relaxed);
+        metrics.coalescedFrames.fetch_add(m_pending_frames - 1, std::memory_order_relaxed);
+        m_pending_frames = 0;
+        ++m_displayed_frames;
+        m_showing_prediction = predicting;
+        emit frameReady(m_latest, predicting ? m_predictor.predict(displayTime) : m_latest);
+    } else if (predicting || m_showing_prediction) {
+        // Same sample, moved on to this refresh. It is not a new snapshot,
+        // so it must not count towards the slot-to-paint latency again.
+        // Once the prediction ran out, the sample itself is shown one last
+        // time so the instruments settle exactly on the received values.
+        AircraftData latest = m_latest;
+        latest.published_ns = 0;
+        AircraftData predicted = predicting ? m_predictor.predict(displayTime) : latest;
+        predicted.published_ns = 0;
+        m_showing_prediction = predicting;
+        ++m_predicted_frames;
+        ++m_idle_ticks;
+        Metrics::instance().predictedFrames.fetch_add(1, std::memory_order_relaxed);
+        emit frameReady(latest, predicted);
+    } else if (++m_idle_ticks > m_refresh_rate) {
+        // No data for about a second: stop ticking until the next submit
+        VLOG_F(1, "Frame scheduler idle, pausing");
+        return;
+    }
+
+    logStatistics();
+    scheduleNextTick();
+}
+
+void FrameScheduler::scheduleNextTick()
+{
+    // Deadlines advance by the exact frame interval so the average rate
+    // matches the display even though QTimer works in whole milliseconds.
+    qint64 now = m_clock.nsecsElapsed();
+    m_next_deadline_ns += m_frame_interval_ns;
+    if (m_next_deadline_ns < now) {
+        // Fell behind (e.g. a long paint); resynchronize instead of bursting
+        m_next_deadline_ns = now + m_frame_interval_ns;
+    }
+    int delayMs = static_cast<int>((m_next_deadline_ns - now + 500000) / 1000000);
+    m_timer.start(delayMs);
+}
+
+void FrameScheduler::updateRefreshRate()
+{
+    if (!m_screen_tracked && m_window && m_window->windowHandle()) {
+        connect(m_window->windowHandle(), &QWindow::screenChanged, this, &FrameScheduler::updateRefreshRate);
+        m_screen_tracked = true;
+    }
+
+    QScreen *screen = m_window ? m_window->screen() : nullptr;
+    qreal rate = screen ? screen->refreshRate() : 0.0;
+    if (rate < 1.0) {
+        rate = 60.0;
+    }
+    if (!qFuzzyCompare(rate, m_refresh_rate) || m_frame_interval_ns == 0) {
+        LOG_F(INFO, "Frame scheduler pacing at %.2f Hz", rate);
+    }
+    m_refresh_rate = rate;
+    m_frame_interval_ns = static_cast<qint64>(1e9 / rate);
+}
+
+void FrameScheduler::logStatistics()
+{
+    qint64 now = m_clock.nsecsElapsed();
+    if (now - m_last_log_ns < 10000000000LL) {
+        return;
+    }
+    m_last_log_ns = now;
+    VLOG_F(1, "Frame scheduler: %llu sim frames, %llu displayed, %llu coalesced, %llu predicted, last %d / max %d per display",
+           m_sim_frames, m_displayed_frames, coalescedFrames(), m_predicted_frames, m_last_frames_per_display, m_max_frames_per_display);
+}
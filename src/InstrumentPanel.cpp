@@ -0,0 +1,122 @@
+#include "InstrumentPanel.h"
+#include <QEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <cmath>
+#include "InstrumentWidget.h"
+#include "Trace.h"
+
+InstrumentPanel::InstrumentPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setGeometry(parent->rect());
+    parent->installEventFilter(this);
+    raise();
+}
+
+InstrumentPanel::~InstrumentPanel()
+{
+    for (InstrumentWidget *instrument : m_instruments) {
+        instrument->setPanel(nullptr);
+    }
+}
+
+void InstrumentPanel::addInstrument(InstrumentWidget *instrument)
+{
+    Q_ASSERT(parentWidget()->isAncestorOf(instrument));
+    m_instruments.append(instrument);
+    instrument->installEventFilter(this);
+    connect(instrument, &QObject::destroyed, this, [this, instrument]() {
+        m_instruments.removeAll(instrument);
+        invalidateAll();
+    });
+    instrument->setPanel(this);
+}
+
+QRect InstrumentPanel::instrumentRect(const InstrumentWidget *instrument) const
+{
+    // The panel covers its parent exactly, so parent and panel coordinates match
+    return QRect(instrument->mapTo(parentWidget(), QPoint(0, 0)), instrument->size());
+}
+
+void InstrumentPanel::invalidate(InstrumentWidget *instrument, const QRect &rect)
+{
+    QRect mapped = rect.translated(instrumentRect(instrument).topLeft());
+    m_dirty += mapped;
+    update(mapped);
+}
+
+void InstrumentPanel::invalidateAll()
+{
+    m_dirty = QRegion(rect());
+    update();
+}
+
+bool InstrumentPanel::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == parentWidget()) {
+        if (event->type() == QEvent::Resize) {
+            setGeometry(parentWidget()->rect());
+        }
+    } else {
+        // Layout changes move instruments around; they are rare, so
+        // everything is redrawn
+        switch (event->type()) {
+        case QEvent::Move:
+        case QEvent::Resize:
+        case QEvent::Show:
+        case QEvent::Hide:
+            invalidateAll();
+            break;
+        default:
+            break;
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void InstrumentPanel::composeDirtyRegion()
+{
+    // Redraw every instrument that touches the dirty region, clipped to it
+    QPainter painter(&m_buffer);
+    painter.setClipRegion(m_dirty);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(rect(), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    for (InstrumentWidget *instrument : m_instruments) {
+        const QRect bounds = instrumentRect(instrument);
+        if (!instrument->isVisible() || !m_dirty.intersects(bounds)) {
+            continue;
+        }
+        painter.setClipRegion(m_dirty & bounds);
+        painter.save();
+        painter.translate(bounds.topLeft());
+        instrument->renderFrame(painter);
+        painter.restore();
+    }
+    m_dirty = QRegion();
+}
+
+void InstrumentPanel::paintEvent(QPaintEvent *event)
+{
+    TRACE_SCOPE("InstrumentPanel::paintEvent");
+    const qreal dpr = devicePixelRatioF();
+    const QSize pixels(qMax(1, static_cast<int>(std::ceil(width() * dpr))), qMax(1, static_cast<int>(std::ceil(height() * dpr))));
+    if (m_buffer.size() != pixels || !qFuzzyCompare(m_buffer.devicePixelRatio(), dpr)) {
+        m_buffer = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+        m_buffer.setDevicePixelRatio(dpr);
+        m_dirty = QRegion(rect());
+    }
+
+    if (!m_dirty.isEmpty()) {
+        composeDirtyRegion();
+    }
+
+    // Exposes without instrument changes only blit the cached image
+    QPainter painter(this);
+    painter.setClipRegion(event->region());
+    painter.drawImage(QPointF(0, 0), m_buffer);
+}
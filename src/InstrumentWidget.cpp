@@ -0,0 +1,300 @@
+#include "InstrumentWidget.h"
+#include <QResizeEvent>
+#include <QThreadPool>
+#include <cmath>
+#include "InstrumentPanel.h"
+#include "LatencyStats.h"
+#include "Trace.h"
+
+InstrumentWidget::InstrumentWidget(qreal logicalSize, QWidget *parent)
+    : QWidget(parent)
+    , m_logical_size(logicalSize)
+{
+}
+
+InstrumentWidget::~InstrumentWidget()
+{
+    // A frame still rendering on the pool uses this object's state
+    m_render_idle.acquire();
+    m_render_idle.release();
+}
+
+void InstrumentWidget::setChangeThreshold(float threshold)
+{
+    m_change_threshold = qMax(0.0f, threshold);
+}
+
+void InstrumentWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (m_panel) {
+        return; // drawn by the panel
+    }
+    QPainter painter(this);
+    if (m_threaded) {
+        if (!m_front_buffer.isNull()) {
+            painter.drawImage(QPointF(0, 0), m_front_buffer);
+            frameShown(m_front_published_ns);
+            m_front_published_ns = 0;
+        }
+        return;
+    }
+    renderFrame(painter);
+}
+
+void InstrumentWidget::renderFrame(QPainter &painter)
+{
+    captureFrame();
+    renderInstrument(painter);
+    frameShown(m_frame_published_ns);
+}
+
+void InstrumentWidget::captureFrame()
+{
+    m_frame_width = width();
+    m_frame_height = height();
+    m_frame_dpr = devicePixelRatioF();
+    m_frame_static_dirty = m_frame_static_dirty || m_static_layers_dirty;
+    m_static_layers_dirty = false;
+    m_frame_published_ns = m_shown_published_ns;
+    m_shown_published_ns = 0;
+    if (!m_paint_metrics) {
+        // Object names are only assigned after construction
+        QByteArray name = objectName().isEmpty() ? QByteArray(metaObject()->className()) : objectName().toUtf8();
+        m_paint_metrics = &Metrics::instance().instrumentPaint(name);
+    }
+    captureRenderState();
+}
+
+void InstrumentWidget::renderInstrument(QPainter &painter)
+{
+    // Class names are static strings, so they can name the span
+    TRACE_SCOPE(metaObject()->className());
+    const qint64 paintStart = LatencyHistogram::now();
+    if (!staticLayersValid()) {
+        rebuildStaticLayers();
+    }
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    int side = qMin(m_frame_width, m_frame_height);
+    QPointF origin((m_frame_width - side) / 2.0, (m_frame_height - side) / 2.0);
+
+    painter.drawImage(origin, m_background_layer);
+
+    painter.save();
+    applyLogicalTransform(painter);
+    drawDynamicLayer(painter);
+    painter.restore();
+
+    if (!m_foreground_layer.isNull()) {
+        painter.drawImage(origin, m_foreground_layer);
+    }
+    painter.restore();
+
+    const qint64 paintDuration = LatencyHistogram::now() - paintStart;
+    LatencyStats::instance().paintDuration.record(paintDuration);
+    m_paint_metrics->count.fetch_add(1, std::memory_order_relaxed);
+    m_paint_metrics->durationNs.fetch_add(static_cast<quint64>(paintDuration), std::memory_order_relaxed);
+}
+
+void InstrumentWidget::frameShown(qint64 publishedNs)
+{
+    if (publishedNs) {
+        LatencyStats::instance().slotToPaint.record(LatencyHistogram::now() - publishedNs);
+    }
+}
+
+void InstrumentWidget::setPanel(InstrumentPanel *panel)
+{
+    m_panel = panel;
+    updateInstrument();
+}
+
+void InstrumentWidget::setThreadedRendering(bool threaded)
+{
+    if (m_threaded == threaded) {
+        return;
+    }
+    m_threaded = threaded;
+    if (!threaded) {
+        // Let a frame in flight finish before the GUI thread draws again
+        m_render_idle.acquire();
+        m_render_idle.release();
+        m_render_in_flight = false;
+        m_render_requested = false;
+        m_front_buffer = QImage();
+        m_back_buffer = QImage();
+    }
+    updateInstrument();
+}
+
+void InstrumentWidget::startThreadedRender()
+{
+    if (m_render_in_flight || !m_render_requested) {
+        return;
+    }
+    m_render_requested = false;
+    m_render_in_flight = true;
+    captureFrame();
+
+    const qreal dpr = m_frame_dpr;
+    const QSize pixels(qMax(1, qCeil(m_frame_width * dpr)), qMax(1, qCeil(m_frame_height * dpr)));
+    if (m_back_buffer.size() != pixels) {
+        m_back_buffer = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+    }
+    m_back_buffer.setDevicePixelRatio(dpr);
+
+    m_render_idle.acquire();
+    QThreadPool::globalInstance()->start([this]() {
+        {
+            QPainter painter(&m_back_buffer);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.fillRect(QRectF(0, 0, m_frame_width, m_frame_height), Qt::transparent);
+            painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+            renderInstrument(painter);
+        }
+        // Queued before the release, so the destructor cannot complete first
+        QMetaObject::invokeMethod(this, &InstrumentWidget::threadedRenderFinished, Qt::QueuedConnection);
+        m_render_idle.release();
+    });
+}
+
+void InstrumentWidget::threadedRenderFinished()
+{
+    if (!m_render_in_flight) {
+        return; // threaded mode was switched off meanwhile
+    }
+    m_render_in_flight = false;
+    std::swap(m_front_buffer, m_back_buffer);
+    m_front_published_ns = m_frame_published_ns;
+    update();
+    startThreadedRender();
+}
+
+void InstrumentWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    invalidateStaticLayers();
+    if (m_threaded) {
+        updateInstrument();
+    }
+}
+
+void InstrumentWidget::drawStaticForeground(QPainter &painter)
+{
+    Q_UNUSED(painter);
+}
+
+bool InstrumentWidget::hasStaticForeground() const
+{
+    return false;
+}
+
+void InstrumentWidget::staticLayersRebuilt()
+{
+}
+
+void InstrumentWidget::captureRenderState()
+{
+}
+
+QImage InstrumentWidget::renderLayer(const std::function<void(QPainter &)> &draw) const
+{
+    int side = qMin(m_frame_width, m_frame_height);
+    int pixels = qMax(1, static_cast<int>(std::ceil(side * m_frame_dpr)));
+
+    QImage layer(pixels, pixels, QImage::Format_ARGB32_Premultiplied);
+    layer.setDevicePixelRatio(m_frame_dpr);
+    layer.fill(Qt::transparent);
+
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(side / 2.0, side / 2.0);
+    painter.scale(side / m_logical_size, side / m_logical_size);
+    draw(painter);
+    return layer;
+}
+
+void InstrumentWidget::invalidateStaticLayers()
+{
+    m_static_layers_dirty = true;
+}
+
+void InstrumentWidget::updateLogicalRect(const QRectF &rect)
+{
+    // The next paint shows the latest snapshot applied through a setter
+    if (m_pending_published_ns) {
+        m_shown_published_ns = m_pending_published_ns;
+        m_pending_published_ns = 0;
+    }
+    // One extra pixel on each side covers antialiasing fringes.
+    scheduleRepaint(logicalTransform().mapRect(rect).toAlignedRect().adjusted(-1, -1, 1, 1));
+}
+
+void InstrumentWidget::updateInstrument()
+{
+    scheduleRepaint(rect());
+}
+
+void InstrumentWidget::scheduleRepaint(const QRect &rect)
+{
+    if (m_panel) {
+        m_panel->invalidate(this, rect);
+    } else if (m_threaded) {
+        // Frames are whole images; changes arriving while one renders are
+        // folded into the next frame.
+        m_render_requested = true;
+        startThreadedRender();
+    } else {
+        update(rect);
+    }
+}
+
+bool InstrumentWidget::exceedsThreshold(float from, float to) const
+{
+    return std::fabs(to - from) >= m_change_threshold;
+}
+
+void InstrumentWidget::applyLogicalTransform(QPainter &painter) const
+{
+    int side = qMin(m_frame_width, m_frame_height);
+    painter.translate(m_frame_width / 2.0, m_frame_height / 2.0);
+    painter.scale(side / m_logical_size, side / m_logical_size);
+}
+
+QTransform InstrumentWidget::logicalTransform() const
+{
+    int side = qMin(width(), height());
+    QTransform transform;
+    transform.translate(width() / 2.0, height() / 2.0);
+    transform.scale(side / m_logical_size, side / m_logical_size);
+    return transform;
+}
+
+qreal InstrumentWidget::deviceScale() const
+{
+    return qMin(m_frame_width, m_frame_height) / m_logical_size * m_frame_dpr;
+}
+
+bool InstrumentWidget::staticLayersValid() const
+{
+    // A window moving to a screen with a different scale factor does not
+    // resize the widget, so the cached device pixel ratio is checked as well.
+    return !m_frame_static_dirty
+        && !m_background_layer.isNull()
+        && qFuzzyCompare(m_background_layer.devicePixelRatio(), m_frame_dpr);
+}
+
+void InstrumentWidget::rebuildStaticLayers()
+{
+    m_background_layer = renderLayer([this](QPainter &painter) { drawStaticBackground(painter); });
+    if (hasStaticForeground()) {
+        m_foreground_layer = renderLayer([this](QPainter &painter) { drawStaticForeground(painter); });
+    } else {
+        m_foreground_layer = QImage();
+    }
+    m_frame_static_dirty = false;
+    staticLayersRebuilt();
+}
@@ -0,0 +1,103 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+    // Values below 2 * SubBucketCount map one to one, above that each power
+    // of two is split into SubBucketCount linear buckets.
+    if (value < 2 * SubBucketCount) {
+        return static_cast<int>(value);
+    }
+    int msb = 63;
+    while (!(value >> msb)) {
+        --msb;
+    }
+    if (msb >= MaxBits) {
+        return BucketCount - 1;
+    }
+    int shift = msb - SubBucketBits;
+    return 2 * SubBucketCount + (shift - 1) * SubBucketCount + static_cast<int>((value >> shift) - SubBucketCount);
+}
+
+std::int64_t LatencyHistogram::bucketMidpoint(int index)
+{
+    if (index < 2 * SubBucketCount) {
+        return index;
+    }
+    int shift = (index - 2 * SubBucketCount) / SubBucketCount + 1;
+    std::int64_t sub = (index - 2 * SubBucketCount) % SubBucketCount + SubBucketCount;
+    return (sub << shift) + (std::int64_t(1) << (shift - 1));
+}
+
+void LatencyHistogram::record(std::int64_t nanoseconds)
+{
+    if (nanoseconds < 0) {
+        nanoseconds = 0;
+    }
+    m_buckets[bucketIndex(static_cast<std::uint64_t>(nanoseconds))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(static_cast<std::uint64_t>(nanoseconds), std::memory_order_relaxed);
+
+    std::int64_t max = m_max.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !m_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+    Summary summary;
+    std::uint64_t counts[BucketCount];
+    std::uint64_t total = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return summary;
+    }
+
+    // Ranks are taken from the bucket snapshot so concurrent records cannot
+    // push them past the end.
+    const std::uint64_t rank50 = (total * 50 + 99) / 100;
+    const std::uint64_t rank99 = (total * 99 + 99) / 100;
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        if (!counts[i]) {
+            continue;
+        }
+        std::uint64_t before = seen;
+        seen += counts[i];
+        if (before < rank50 && seen >= rank50) {
+            summary.p50 = bucketMidpoint(i);
+        }
+        if (before < rank99 && seen >= rank99) {
+            summary.p99 = bucketMidpoint(i);
+            break;
+        }
+    }
+
+    summary.count = total;
+    summary.max = m_max.load(std::memory_order_relaxed);
+    summary.p50 = summary.p50 < summary.max ? summary.p50 : summary.max;
+    summary.p99 = summary.p99 < summary.max ? summary.p99 : summary.max;
+    std::uint64_t count = m_count.load(std::memory_order_relaxed);
+    summary.mean = count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0.0;
+    return summary;
+}
+
+void LatencyHistogram::reset()
+{
+    // Not atomic as a whole; samples recorded concurrently may be lost
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+#include "LatencyOverlay.h"
+#include <QFontDatabase>
+#include <QPainter>
+#include "LatencyStats.h"
+
+LatencyOverlay::LatencyOverlay(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_timer.setInterval(250);
+    connect(&m_timer, &QTimer::timeout, this, &LatencyOverlay::refresh);
+    hide();
+}
+
+void LatencyOverlay::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0, 0, 0, 170));
+    painter.setPen(Qt::green);
+    painter.drawText(rect().adjusted(6, 4, -6, -4), Qt::AlignLeft | Qt::AlignVCenter, m_text);
+}
+
+void LatencyOverlay::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_timer.start();
+}
+
+void LatencyOverlay::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_timer.stop();
+}
+
+void LatencyOverlay::refresh()
+{
+    m_text = LatencyStats::instance().report();
+    QSize size = fontMetrics().size(0, m_text) + QSize(12, 8);
+    if (size != this->size()) {
+        setGeometry(QRect(QPoint(8, 8), size));
+    }
+    raise();
+    update();
+}
@@ -0,0 +1,49 @@
+#include "LatencyStats.h"
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+LatencyStats &LatencyStats::instance()
+{
+    static LatencyStats stats;
+    return stats;
+}
+
+static QString reportLine(const char *name, const LatencyHistogram &histogram)
+{
+    const LatencyHistogram::Summary summary = histogram.summary();
+    return QString("%1 n=%2  p50 %3  p99 %4  max %5 ms")
+        .arg(QLatin1String(name), -15)
+        .arg(summary.count, -8)
+        .arg(summary.p50 / 1e6, 7, 'f', 3)
+        .arg(summary.p99 / 1e6, 7, 'f', 3)
+        .arg(summary.max / 1e6, 7, 'f', 3);
+}
+
+QString LatencyStats::report() const
+{
+    return reportLine("receive->slot", receiveToSlot) + '\n'
+        + reportLine("slot->paint", slotToPaint) + '\n'
+        + reportLine("paint", paintDuration) + '\n'
+        + reportLine("command->ack", commandAck);
+}
+
+bool LatencyStats::dumpToFile(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out << "# " << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << '\n'
+        << report() << "\n\n";
+    return out.status() == QTextStream::Ok;
+}
+
+void LatencyStats::reset()
+{
+    receiveToSlot.reset();
+    slotToPaint.reset();
+    paintDuration.reset();
+    commandAck.reset();
+}
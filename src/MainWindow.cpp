@@ -1,25 +1,81 @@
 #include "MainWindow.h"
 #include "ui_mainwindow.h"
+#include "ReplaySource.h"
+#include "LatencyStats.h"
+#include "LatencyOverlay.h"
+#include "Metrics.h"
+#include "CommandPipeline.h"
+#include "Trace.h"
+#include <QDateTime>
+#include <QFile>
+#include <QMetaEnum>
 #include <QDesktopServices>
+#include <QShortcut>
+#include <QThreadPool>
 #include <QUrl>
+#include <cmath>
 #include <loguru.hpp>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-MainWindow::MainWindow(QWidget *parent)
+// Built-in alerts. User rules loaded with --alert-rules are added on top and
+// replace the rules named here; see AlertEngine.h for the syntax.
+static const char default_alert_rules[] = R"(
+gear_damaged "GEAR DAMAGED" priority 3 when gear_damage_by_speed != 0
+gear_unsafe "GEAR UNSAFE" priority 2 when gear_warning_center > 0 or gear_warning_left > 0 or gear_warning_right > 0
+gear_not_down "GEAR NOT DOWN" priority 1 when gear_total_extended_pct < 1 and plane_alt_above_ground < 1000 for 2s clear when gear_total_extended_pct >= 1 or plane_alt_above_ground > 1200
+
+# Drive the engine start/stop buttons, with a little hysteresis around 15% N1
+engine_1_running when eng_n1_1 > 15 clear when eng_n1_1 < 14
+engine_2_running when eng_n1_2 > 15 clear when eng_n1_2 < 14
+engine_3_running when eng_n1_3 > 15 clear when eng_n1_3 < 14
+engine_4_running when eng_n1_4 > 15 clear when eng_n1_4 < 14
+)";
+
+static_assert(AircraftSchema::eng_n1_4 == AircraftSchema::eng_n1_1 + 3
+              && AircraftSchema::throttle_4 == AircraftSchema::throttle_1 + 3,
+              "Engine fields must be consecutive in the schema");
+
+MainWindow::MainWindow(TelemetrySource *telemetrySource, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , m_simConnectClient(new SimConnectClient(this))
+    , m_telemetrySource(telemetrySource)
+    , m_frameScheduler(new FrameScheduler(this, this))
 {
     ui->setupUi(this);
-
-    connect(m_simConnectClient, &SimConnectClient::connected, this, &MainWindow::onSimConnected);
-    connect(m_simConnectClient, &SimConnectClient::disconnected, this, &MainWindow::onSimDisconnected);
-    connect(m_simConnectClient, &SimConnectClient::aircraftDataUpdated, this, &MainWindow::onAircraftDataUpdated);
-
-    m_simConnectClient->connectToSim();
+    m_telemetrySource->setParent(this);
+    m_commandPipeline = new CommandPipeline(m_telemetrySource, this);
+
+    m_rpmIndicators = { ui->rpmIndicator1, ui->rpmIndicator2, ui->rpmIndicator3, ui->rpmIndicator4 };
+    m_engineButtons = { ui->eng1Button, ui->eng2Button, ui->eng3Button, ui->eng4Button };
+    for (int i = 0; i < 4; ++i) {
+        m_engineStartTexts[i] = QString("Start Eng %1").arg(i + 1);
+        m_engineStopTexts[i] = QString("Stop Eng %1").arg(i + 1);
+    }
+    m_alertEngine.compile(default_alert_rules, "built-in alert rules");
+    for (int i = 0; i < 4; ++i) {
+        // Replacing a rule keeps its index, so these survive loadAlertRules
+        m_engineRunningRules[i] = m_alertEngine.find("engine_" + std::to_string(i + 1) + "_running");
+    }
+    m_alertTimer.setSingleShot(true);
+    m_alertTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_alertTimer, &QTimer::timeout, this, [this]() {
+        if (m_hasAircraftData) {
+            evaluateAlerts(m_currentAircraftData, 0);
+        }
+    });
+    m_latencyOverlay = new LatencyOverlay(ui->centralwidget);
+
+    connect(m_telemetrySource, &TelemetrySource::connected, this, &MainWindow::onSimConnected);
+    connect(m_telemetrySource, &TelemetrySource::disconnected, this, &MainWindow::onSimDisconnected);
+    // Sim frames are coalesced to one UI update per display refresh
+    connect(m_telemetrySource, &TelemetrySource::aircraftDataUpdated, m_frameScheduler, &FrameScheduler::submit);
+    connect(m_frameScheduler, &FrameScheduler::frameReady, this, &MainWindow::onAircraftDataUpdated);
+    connect(m_telemetrySource, &TelemetrySource::trafficUpdated, this, &MainWindow::onTrafficUpdated);
+    // Every sim frame, so acknowledgement latency is not quantized to the display
+    connect(m_telemetrySource, &TelemetrySource::aircraftDataUpdated, m_commandPipeline, &CommandPipeline::observe);
+    connect(m_commandPipeline, &CommandPipeline::timedOut, this, [this](TelemetrySource::EVENT_ID eventId) {
+        ui->statusbar->showMessage(QString("%1 was not acknowledged by the sim")
+                                       .arg(QMetaEnum::fromType<TelemetrySource::EVENT_ID>().valueToKey(eventId)), 5000);
+    });
 
     ui->rpmIndicator1->setTitle("ENG 1");
     ui->rpmIndicator2->setTitle("ENG 2");
@@ -28,37 +84,94 @@ MainWindow::MainWindow(QWidget *parent)
 
     updateControlsState(false);
 
+    // The gear and engine buttons reach their on_<name>_<signal> slots
+    // through setupUi's auto-connection; connecting them again here would
+    // send every command twice.
     connect(ui->connectButton, &QPushButton::clicked, this, &MainWindow::onConnectClicked);
-    connect(ui->gearButton, &QPushButton::clicked, this, &MainWindow::onGearButtonToggled);
 
-    connect(ui->eng1Button, &QPushButton::toggled, this, &MainWindow::on_eng1Button_toggled);
-    connect(ui->eng2Button, &QPushButton::toggled, this, &MainWindow::on_eng2Button_toggled);
-    connect(ui->eng3Button, &QPushButton::toggled, this, &MainWindow::on_eng3Button_toggled);
-    connect(ui->eng4Button, &QPushButton::toggled, this, &MainWindow::on_eng4Button_toggled);
+    // Playback controls when driven by a recorded flight
+    if (auto *replay = qobject_cast<ReplaySource *>(m_telemetrySource)) {
+        connect(new QShortcut(Qt::Key_Space, this), &QShortcut::activated, replay, &ReplaySource::togglePause);
+        connect(new QShortcut(Qt::Key_Right, this), &QShortcut::activated, replay, &ReplaySource::stepFrame);
+        connect(new QShortcut(Qt::Key_Plus, this), &QShortcut::activated, replay, [replay]() { replay->setSpeed(replay->speed() * 2.0); });
+        connect(new QShortcut(Qt::Key_Minus, this), &QShortcut::activated, replay, [replay]() { replay->setSpeed(replay->speed() / 2.0); });
+        connect(new QShortcut(Qt::Key_Home, this), &QShortcut::activated, replay, [replay]() { replay->seek(0); });
+    }
 
     onSimDisconnected(); // Set initial state
+
+    // Last: local sources emit connected() from within connectToSim()
+    m_telemetrySource->connectToSim();
 }
 
 MainWindow::~MainWindow()
 {
+    // The worker must not outlive the telemetry source it sends to
+    m_commandPipeline->stop();
+    // Frames rendering on the pool call into the instruments being deleted
+    setRenderMode(InstrumentRenderMode::Widgets);
     delete ui;
 }
 
+void MainWindow::setRenderMode(InstrumentRenderMode mode)
+{
+    const bool composite = mode == InstrumentRenderMode::Composite;
+    const bool threaded = mode == InstrumentRenderMode::Threaded;
+    QList<InstrumentWidget *> instruments { ui->attitudeIndicator, ui->compass, ui->trafficDisplay };
+    for (RpmIndicator *indicator : m_rpmIndicators) {
+        instruments.append(indicator);
+    }
+
+    for (InstrumentWidget *instrument : instruments) {
+        instrument->setThreadedRendering(threaded);
+    }
+
+    if (composite && !m_instrumentPanel) {
+        m_instrumentPanel = new InstrumentPanel(ui->centralwidget);
+        for (InstrumentWidget *instrument : instruments) {
+            m_instrumentPanel->addInstrument(instrument);
+        }
+        m_instrumentPanel->show();
+        m_latencyOverlay->raise();
+    } else if (!composite && m_instrumentPanel) {
+        delete m_instrumentPanel;
+        m_instrumentPanel = nullptr;
+    }
+
+    if (composite) {
+        LOG_F(INFO, "Rendering instruments through a composite panel");
+    } else if (threaded) {
+        LOG_F(INFO, "Rendering instruments on %d pool threads", QThreadPool::globalInstance()->maxThreadCount());
+    } else {
+        LOG_F(INFO, "Rendering instruments as individual widgets");
+    }
+}
+
+bool MainWindow::loadAlertRules(const QString &path)
+{
+    if (!m_alertEngine.loadFile(path)) {
+        return false;
+    }
+    LOG_F(INFO, "%zu alert rules active", m_alertEngine.ruleCount());
+    return true;
+}
+
 void MainWindow::onConnectClicked()
 {
-    if (m_simConnectClient->isConnected())
+    if (m_telemetrySource->isConnected())
     {
-        m_simConnectClient->disconnectFromSim();
+        m_telemetrySource->disconnectFromSim();
     }
     else
     {
-        m_simConnectClient->connectToSim();
+        m_telemetrySource->connectToSim();
     }
 }
 
 void MainWindow::onSimConnected()
 {
-    LOG_F(INFO, "SimConnect connected - updating UI state");
+    LOG_F(INFO, "Telemetry source connected - updating UI state");
+    Metrics::instance().setConnected(true);
     ui->connectButton->setText("Disconnect");
     ui->statusLight->setStyleSheet("border-radius: 10px; background-color: green;");
     updateControlsState(true);
@@ -66,116 +179,194 @@ void MainWindow::onSimConnected()
 
 void MainWindow::onSimDisconnected()
 {
-    LOG_F(INFO, "SimConnect disconnected - resetting UI state");
+    LOG_F(INFO, "Telemetry source disconnected - resetting UI state");
+    Metrics::instance().setConnected(false);
     ui->connectButton->setText("Connect");
     ui->statusLight->setStyleSheet("border-radius: 10px; background-color: red;");
     updateControlsState(false);
-    
-    // Reset UI to default state
+    m_frameScheduler->reset();
+    m_commandPipeline->clear();
+
+    LOG_F(INFO, "Frame scheduler - sim frames: %llu, displayed: %llu, coalesced: %llu",
+          m_frameScheduler->simFrames(), m_frameScheduler->displayedFrames(), m_frameScheduler->coalescedFrames());
+    LOG_F(INFO, "Suppressed instrument repaints - attitude: %llu, compass: %llu, rpm: %llu/%llu/%llu/%llu",
+          ui->attitudeIndicator->suppressedRepaints(), ui->compass->suppressedRepaints(),
+          ui->rpmIndicator1->suppressedRepaints(), ui->rpmIndicator2->suppressedRepaints(),
+          ui->rpmIndicator3->suppressedRepaints(), ui->rpmIndicator4->suppressedRepaints());
+    LOG_F(INFO, "Telemetry latency:\n%s", qPrintable(LatencyStats::instance().report()));
+
+    // Reset UI to default state, which is not telemetry and must not count as latency
+    setInstrumentDataTimestamp(0);
     ui->gearLabel->setText("Gear: ---%");
     ui->gearWarningLabel->setText("");
+    m_alertEngine.reset();
+    m_alertTimer.stop();
     ui->gearCenterLabel->setText("C: ---%");
     ui->gearLeftLabel->setText("L: ---%");
     ui->gearRightLabel->setText("R: ---%");
-    ui->attitudeIndicator->setRoll(0);
-    ui->attitudeIndicator->setPitch(0);
+    ui->attitudeIndicator->setAttitude(0, 0);
     ui->compass->setHeading(0);
     ui->gearButton->setChecked(false);
+    m_trafficStore.clear();
+    ui->trafficDisplay->clearTraffic();
+
+    for (int i = 0; i < 4; ++i) {
+        m_rpmIndicators[i]->setRpmPercent(0);
+        m_rpmIndicators[i]->setThrottlePercent(0);
+        m_engineButtons[i]->setChecked(false);
+        m_engineButtons[i]->setText(m_engineStartTexts[i]);
+    }
+
+    // Widgets no longer show the last received data
+    m_hasAircraftData = false;
+    m_displayState = DisplayState();
+}
+
+void MainWindow::onTrafficUpdated(const TrafficBatch &batch)
+{
+    TRACE_SCOPE("MainWindow::onTrafficUpdated");
+    if (!m_telemetrySource->isConnected()) {
+        return; // queued before the disconnect
+    }
+    m_trafficStore.apply(batch);
+    m_trafficStore.nearest(TrafficDisplay::MaxContacts, ui->trafficDisplay->range(), m_trafficContacts);
+    ui->trafficDisplay->setTraffic(m_trafficContacts, m_trafficStore.ownshipTrackDeg());
+    Metrics::instance().trafficObjects.store(m_trafficStore.size(), std::memory_order_relaxed);
+}
 
-    ui->rpmIndicator1->setRpmPercent(0);
-    ui->rpmIndicator2->setRpmPercent(0);
-    ui->rpmIndicator3->setRpmPercent(0);
-    ui->rpmIndicator4->setRpmPercent(0);
-    ui->rpmIndicator1->setThrottlePercent(0);
-    ui->rpmIndicator2->setThrottlePercent(0);
-    ui->rpmIndicator3->setThrottlePercent(0);
-    ui->rpmIndicator4->setThrottlePercent(0);
-    ui->eng1Button->setChecked(false);
-    ui->eng1Button->setText("Start Eng 1");
-    ui->eng2Button->setChecked(false);
-    ui->eng2Button->setText("Start Eng 2");
-    ui->eng3Button->setChecked(false);
-    ui->eng3Button->setText("Start Eng 3");
-    ui->eng4Button->setChecked(false);
-    ui->eng4Button->setText("Start Eng 4");
-}
-
-void MainWindow::onAircraftDataUpdated(const AircraftData &data)
+void MainWindow::onAircraftDataUpdated(const AircraftData &data, const AircraftData &display)
 {
+    TRACE_SCOPE("MainWindow::onAircraftDataUpdated");
     VLOG_F(2, "Aircraft data updated - gear: %.1f%%, heading: %.1f°", 
            data.gear_total_extended_pct * 100.0, data.plane_heading_degrees_true);
-    m_currentAircraftData = data;
+
+    // Instruments repainted because of this update record its latency
+    setInstrumentDataTimestamp(display.published_ns);
+
+    // Compare against what was last applied so steady flight touches no widgets.
+    // Labels are compared at the precision they are displayed with. Only the
+    // attitude, compass and N1 setters take the predicted display frame.
+    const std::uint64_t changed = m_hasAircraftData ? AircraftSchema::diff(m_currentAircraftData, data) : ~std::uint64_t(0);
+    const std::uint64_t moved = m_hasAircraftData ? AircraftSchema::diff(m_displayedAircraftData, display) : ~std::uint64_t(0);
+    DisplayState &shown = m_displayState;
 
     // Update Gear
-    ui->gearLabel->setText(QString("Gear: %1%").arg(data.gear_total_extended_pct * 100.0, 0, 'f', 1));
-    ui->gearCenterLabel->setText(QString("C: %1%").arg(data.gear_pos_center * 100.0, 3, 'f', 0));
-    ui->gearLeftLabel->setText(QString("L: %1%").arg(data.gear_pos_left * 100.0, 3, 'f', 0));
-    ui->gearRightLabel->setText(QString("R: %1%").arg(data.gear_pos_right * 100.0, 3, 'f', 0));
-    
-    // Block signals to prevent feedback loop while we set the checked state
-    ui->gearButton->blockSignals(true);
-    ui->gearButton->setChecked(data.gear_handle_position > 0.5);
-    ui->gearButton->blockSignals(false);
+    long long gearTotal = std::llround(data.gear_total_extended_pct * 1000.0);
+    if (gearTotal != shown.gear_total_tenths) {
+        shown.gear_total_tenths = gearTotal;
+        ui->gearLabel->setText(QString("Gear: %1%").arg(data.gear_total_extended_pct * 100.0, 0, 'f', 1));
+    }
+    long long gearCenter = std::llround(data.gear_pos_center * 100.0);
+    if (gearCenter != shown.gear_center_pct) {
+        shown.gear_center_pct = gearCenter;
+        ui->gearCenterLabel->setText(QString("C: %1%").arg(data.gear_pos_center * 100.0, 3, 'f', 0));
+    }
+    long long gearLeft = std::llround(data.gear_pos_left * 100.0);
+    if (gearLeft != shown.gear_left_pct) {
+        shown.gear_left_pct = gearLeft;
+        ui->gearLeftLabel->setText(QString("L: %1%").arg(data.gear_pos_left * 100.0, 3, 'f', 0));
+    }
+    long long gearRight = std::llround(data.gear_pos_right * 100.0);
+    if (gearRight != shown.gear_right_pct) {
+        shown.gear_right_pct = gearRight;
+        ui->gearRightLabel->setText(QString("R: %1%").arg(data.gear_pos_right * 100.0, 3, 'f', 0));
+    }
+
+    int gearHandleDown = data.gear_handle_position != 0 ? 1 : 0;
+    if (gearHandleDown != shown.gear_handle_down) {
+        shown.gear_handle_down = gearHandleDown;
+        // Block signals to prevent feedback loop while we set the checked state
+        ui->gearButton->blockSignals(true);
+        ui->gearButton->setChecked(gearHandleDown);
+        ui->gearButton->blockSignals(false);
+    }
 
     // Update Attitude Indicator
-    float roll_deg = static_cast<float>(data.attitude_bank_radians * 180.0 / M_PI);
-    float pitch_deg = static_cast<float>(data.attitude_pitch_radians * 180.0 / M_PI);
-    ui->attitudeIndicator->setRoll(roll_deg);
-    ui->attitudeIndicator->setPitch(pitch_deg);
+    if (moved & (AircraftSchema::bit(AircraftSchema::attitude_bank_degrees) | AircraftSchema::bit(AircraftSchema::attitude_pitch_degrees))) {
+        ui->attitudeIndicator->setAttitude(display.attitude_bank_degrees, display.attitude_pitch_degrees);
+    }
 
     // Update Compass
-    ui->compass->setHeading(static_cast<float>(data.plane_heading_degrees_true));
+    if (moved & AircraftSchema::bit(AircraftSchema::plane_heading_degrees_true)) {
+        ui->compass->setHeading(display.plane_heading_degrees_true);
+    }
 
     // Update RPM Indicators
-    ui->rpmIndicator1->setRpmPercent(static_cast<float>(data.eng_n1_1));
-    ui->rpmIndicator2->setRpmPercent(static_cast<float>(data.eng_n1_2));
-    ui->rpmIndicator3->setRpmPercent(static_cast<float>(data.eng_n1_3));
-    ui->rpmIndicator4->setRpmPercent(static_cast<float>(data.eng_n1_4));
-
-    ui->rpmIndicator1->setThrottlePercent(static_cast<float>(data.throttle_1));
-    ui->rpmIndicator2->setThrottlePercent(static_cast<float>(data.throttle_2));
-    ui->rpmIndicator3->setThrottlePercent(static_cast<float>(data.throttle_3));
-    ui->rpmIndicator4->setThrottlePercent(static_cast<float>(data.throttle_4));
-
-    // Update engine button states based on N1
-    const float n1_running_threshold = 15.0f;
-    ui->eng1Button->blockSignals(true);
-    bool eng1_running = data.eng_n1_1 > n1_running_threshold;
-    ui->eng1Button->setChecked(eng1_running);
-    ui->eng1Button->setText(eng1_running ? "Stop Eng 1" : "Start Eng 1");
-    ui->eng1Button->blockSignals(false);
-
-    ui->eng2Button->blockSignals(true);
-    bool eng2_running = data.eng_n1_2 > n1_running_threshold;
-    ui->eng2Button->setChecked(eng2_running);
-    ui->eng2Button->setText(eng2_running ? "Stop Eng 2" : "Start Eng 2");
-    ui->eng2Button->blockSignals(false);
-
-    ui->eng3Button->blockSignals(true);
-    bool eng3_running = data.eng_n1_3 > n1_running_threshold;
-    ui->eng3Button->setChecked(eng3_running);
-    ui->eng3Button->setText(eng3_running ? "Stop Eng 3" : "Start Eng 3");
-    ui->eng3Button->blockSignals(false);
-
-    ui->eng4Button->blockSignals(true);
-    bool eng4_running = data.eng_n1_4 > n1_running_threshold;
-    ui->eng4Button->setChecked(eng4_running);
-    ui->eng4Button->setText(eng4_running ? "Stop Eng 4" : "Start Eng 4");
-    ui->eng4Button->blockSignals(false);
-
-    // Update Gear Warning
-    bool gearDamaged = data.gear_damage_by_speed > 0.5;
-    bool gearWarning = data.gear_warning_center > 0 || data.gear_warning_left > 0 || data.gear_warning_right > 0;
-
-    if (gearDamaged) {
-        ui->gearWarningLabel->setText("GEAR DAMAGED");
-    } else if (gearWarning) {
-        ui->gearWarningLabel->setText("GEAR UNSAFE");
+    const float n1[4] = { display.eng_n1_1, display.eng_n1_2, display.eng_n1_3, display.eng_n1_4 };
+    const float throttle[4] = { data.throttle_1, data.throttle_2, data.throttle_3, data.throttle_4 };
+
+    for (int i = 0; i < 4; ++i) {
+        if (moved & AircraftSchema::bit(static_cast<AircraftSchema::FieldId>(AircraftSchema::eng_n1_1 + i))) {
+            m_rpmIndicators[i]->setRpmPercent(n1[i]);
+        }
+        if (changed & AircraftSchema::bit(static_cast<AircraftSchema::FieldId>(AircraftSchema::throttle_1 + i))) {
+            m_rpmIndicators[i]->setThrottlePercent(throttle[i]);
+        }
+    }
+
+    // Warnings and engine running state come from the alert rules, which
+    // must see the sim state as received, never a prediction
+    evaluateAlerts(data, changed);
+
+    m_currentAircraftData = data;
+    m_displayedAircraftData = display;
+    m_hasAircraftData = true;
+}
+
+void MainWindow::evaluateAlerts(const AircraftData &data, std::uint64_t changed)
+{
+    const std::int64_t now = LatencyHistogram::now();
+    bool messagesChanged = false;
+    for (std::uint32_t index : m_alertEngine.evaluate(data, changed, now)) {
+        const AlertEngine::Rule &rule = m_alertEngine.rule(index);
+        const bool active = m_alertEngine.isActive(index);
+        VLOG_F(1, "Alert %s %s", rule.name.c_str(), active ? "raised" : "cleared");
+        for (int i = 0; i < 4; ++i) {
+            if (m_engineRunningRules[i] == static_cast<int>(index)) {
+                setEngineRunning(i, active);
+            }
+        }
+        messagesChanged = messagesChanged || !rule.message.empty();
+    }
+    if (messagesChanged) {
+        updateAlertMessage();
+    }
+
+    if (std::int64_t deadline = m_alertEngine.nextDeadline()) {
+        // Rounded up, so the timer never fires just before the deadline
+        m_alertTimer.start(static_cast<int>((deadline - now + 999999) / 1000000));
+    } else {
+        m_alertTimer.stop();
+    }
+}
+
+void MainWindow::updateAlertMessage()
+{
+    // The active alert with the highest priority wins, the first one on ties
+    int shown = -1;
+    for (std::size_t i = 0; i < m_alertEngine.ruleCount(); ++i) {
+        const AlertEngine::Rule &rule = m_alertEngine.rule(i);
+        if (m_alertEngine.isActive(i) && !rule.message.empty()
+            && (shown < 0 || rule.priority > m_alertEngine.rule(shown).priority)) {
+            shown = static_cast<int>(i);
+        }
+    }
+    if (shown >= 0) {
+        ui->gearWarningLabel->setText(QString::fromStdString(m_alertEngine.rule(shown).message));
     } else {
-        ui->gearWarningLabel->setText("");
+        ui->gearWarningLabel->clear();
     }
 }
 
+void MainWindow::setEngineRunning(int engine, bool running)
+{
+    QPushButton *button = m_engineButtons[engine];
+    button->blockSignals(true);
+    button->setChecked(running);
+    button->setText(running ? m_engineStopTexts[engine] : m_engineStartTexts[engine]);
+    button->blockSignals(false);
+}
+
 void MainWindow::updateControlsState(bool isConnected)
 {
     ui->gearButton->setEnabled(isConnected);
@@ -187,133 +378,168 @@ void MainWindow::on_actionsource_code_triggered()
     QDesktopServices::openUrl(QUrl("https://github.com/zacario-li/msfs_dashboard"));
 }
 
-void MainWindow::onGearButtonToggled(bool checked)
+void MainWindow::on_actionlatency_overlay_toggled(bool checked)
+{
+    m_latencyOverlay->setVisible(checked);
+}
+
+void MainWindow::on_actiondump_latency_triggered()
+{
+    const QString path = "msfs_dashboard_latency.txt";
+    if (LatencyStats::instance().dumpToFile(path)) {
+        LOG_F(INFO, "Latency statistics appended to %s", qPrintable(path));
+        ui->statusbar->showMessage(QString("Latency statistics appended to %1").arg(path), 5000);
+    } else {
+        LOG_F(ERROR, "Failed to write latency statistics to %s", qPrintable(path));
+        ui->statusbar->showMessage(QString("Failed to write %1").arg(path), 5000);
+    }
+}
+
+void MainWindow::on_actiontrace_recording_toggled(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        LOG_F(INFO, "Gear button toggled: %s", checked ? "DOWN" : "UP");
-        m_simConnectClient->transmitEvent(checked ? SimConnectClient::EVENT_GEAR_DOWN : SimConnectClient::EVENT_GEAR_UP);
+    if (checked) {
+        Trace::setEnabled(true);
+        ui->statusbar->showMessage("Recording trace, toggle again to save it");
+        return;
+    }
+
+    Trace::setEnabled(false);
+    const QString path = QString("msfs_dashboard_trace_%1.json")
+                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    if (Trace::dumpChromeJson(QFile::encodeName(path).toStdString())) {
+        ui->statusbar->showMessage(QString("Trace saved to %1").arg(path), 5000);
     } else {
-        LOG_F(WARNING, "Gear button toggled but SimConnect not connected");
+        ui->statusbar->showMessage(QString("Failed to write %1").arg(path), 5000);
+    }
+}
+
+void MainWindow::setInstrumentDataTimestamp(qint64 publishedNs)
+{
+    ui->attitudeIndicator->setDataTimestamp(publishedNs);
+    ui->compass->setDataTimestamp(publishedNs);
+    for (RpmIndicator *indicator : m_rpmIndicators) {
+        indicator->setDataTimestamp(publishedNs);
     }
 }
 
 void MainWindow::on_eng1Button_toggled(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
+    if (m_telemetrySource->isConnected()) {
         if (checked) {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_TOGGLE_ENGINE1_STARTER, 1);
+            m_commandPipeline->submit(TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER, 1);
         } else {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_ENGINE_AUTO_SHUTDOWN, 1);
+            m_commandPipeline->submit(TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN, 1);
         }
     }
 }
 
 void MainWindow::on_eng2Button_toggled(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
+    if (m_telemetrySource->isConnected()) {
         if (checked) {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_TOGGLE_ENGINE2_STARTER, 1);
+            m_commandPipeline->submit(TelemetrySource::EVENT_TOGGLE_ENGINE2_STARTER, 1);
         } else {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_ENGINE_AUTO_SHUTDOWN, 2);
+            m_commandPipeline->submit(TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN, 2);
         }
     }
 }
 
 void MainWindow::on_eng3Button_toggled(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
+    if (m_telemetrySource->isConnected()) {
         if (checked) {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_TOGGLE_ENGINE3_STARTER, 1);
+            m_commandPipeline->submit(TelemetrySource::EVENT_TOGGLE_ENGINE3_STARTER, 1);
         } else {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_ENGINE_AUTO_SHUTDOWN, 3);
+            m_commandPipeline->submit(TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN, 3);
         }
     }
 }
 
 void MainWindow::on_eng4Button_toggled(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
+    if (m_telemetrySource->isConnected()) {
         if (checked) {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_TOGGLE_ENGINE4_STARTER, 1);
+            m_commandPipeline->submit(TelemetrySource::EVENT_TOGGLE_ENGINE4_STARTER, 1);
         } else {
-            m_simConnectClient->transmitEvent(SimConnectClient::EVENT_ENGINE_AUTO_SHUTDOWN, 4);
+            m_commandPipeline->submit(TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN, 4);
         }
     }
 }
 
 void MainWindow::on_gearButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(checked ? SimConnectClient::EVENT_GEAR_DOWN : SimConnectClient::EVENT_GEAR_UP);
+    if (m_telemetrySource->isConnected()) {
+        LOG_F(INFO, "Gear button clicked: %s", checked ? "DOWN" : "UP");
+        m_commandPipeline->submit(checked ? TelemetrySource::EVENT_GEAR_DOWN : TelemetrySource::EVENT_GEAR_UP);
     }
 }
 
 void MainWindow::on_parkingBrakeButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_PARKING_BRAKES);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_PARKING_BRAKES);
     }
 }
 
 void MainWindow::on_fdButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_TOGGLE_FLIGHT_DIRECTOR);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_TOGGLE_FLIGHT_DIRECTOR);
     }
 }
 
 void MainWindow::on_apButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_MASTER);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_MASTER);
     }
 }
 
 void MainWindow::on_navButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_NAV1_HOLD);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_NAV1_HOLD);
     }
 }
 
 void MainWindow::on_aprButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_APR_HOLD);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_APR_HOLD);
     }
 }
 
 void MainWindow::on_athrButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AUTO_THROTTLE_ARM);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AUTO_THROTTLE_ARM);
     }
 }
 
 void MainWindow::on_altButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_ALT_HOLD);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_ALT_HOLD);
     }
 }
 
 void MainWindow::on_vsButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_VS_HOLD);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_VS_HOLD);
     }
 }
 
 void MainWindow::on_flcButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_FLC_HOLD);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_FLC_HOLD);
     }
 }
 
 void MainWindow::on_hdgButton_clicked(bool checked)
 {
-    if (m_simConnectClient->isConnected()) {
-        m_simConnectClient->transmitEvent(SimConnectClient::EVENT_AP_WING_LEVELER);
+    if (m_telemetrySource->isConnected()) {
+        m_commandPipeline->submit(TelemetrySource::EVENT_AP_WING_LEVELER);
     }
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "Metrics.h"
+#include <QMetaEnum>
+#include "LatencyStats.h"
+#include "TelemetrySource.h"
+
+Metrics &Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+void Metrics::countSimConnectMessage(unsigned id)
+{
+    // Everything past the table shares the last slot
+    count(m_simconnect_messages, static_cast<int>(qMin<unsigned>(id, MaxSimConnectMessageTypes - 1)), MaxSimConnectMessageTypes);
+}
+
+void Metrics::setSimConnectMessageName(unsigned id, const char *name)
+{
+    if (id < MaxSimConnectMessageTypes) {
+        m_simconnect_message_names[id].store(name, std::memory_order_relaxed);
+    }
+}
+
+Metrics::InstrumentPaint &Metrics::instrumentPaint(const QByteArray &name)
+{
+    std::lock_guard<std::mutex> lock(m_instruments_mutex);
+    for (InstrumentPaint &instrument : m_instruments) {
+        if (instrument.name == name) {
+            return instrument;
+        }
+    }
+    m_instruments.emplace_back();
+    m_instruments.back().name = name;
+    return m_instruments.back();
+}
+
+void Metrics::setConnected(bool connected)
+{
+    if (m_connected.exchange(connected, std::memory_order_relaxed) == connected) {
+        return;
+    }
+    (connected ? m_connects : m_disconnects).fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace {
+
+// Builds the exposition text one metric family at a time
+class PrometheusWriter
+{
+public:
+    void family(const char *name, const char *type, const char *help)
+    {
+        m_text += "# HELP ";
+        m_text += name;
+        m_text += ' ';
+        m_text += help;
+        m_text += "\n# TYPE ";
+        m_text += name;
+        m_text += ' ';
+        m_text += type;
+        m_text += '\n';
+    }
+
+    void sample(const char *name, double value, const char *labelName = nullptr, const QByteArray &labelValue = QByteArray(),
+                const char *labelName2 = nullptr, const QByteArray &labelValue2 = QByteArray())
+    {
+        m_text += name;
+        if (labelName) {
+            m_text += '{';
+            label(labelName, labelValue);
+            if (labelName2) {
+                m_text += ',';
+                label(labelName2, labelValue2);
+            }
+            m_text += '}';
+        }
+        m_text += ' ';
+        m_text += QByteArray::number(value, 'g', 17);
+        m_text += '\n';
+    }
+
+    QByteArray text() const { return m_text; }
+
+private:
+    void label(const char *name, const QByteArray &value)
+    {
+        m_text += name;
+        m_text += "=\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                m_text += '\\';
+            }
+            m_text += c == '\n' ? ' ' : c;
+        }
+        m_text += '"';
+    }
+
+    QByteArray m_text;
+};
+
+std::uint64_t load(const std::atomic<std::uint64_t> &counter)
+{
+    return counter.load(std::memory_order_relaxed);
+}
+
+void writeLatency(PrometheusWriter &writer, const char *stage, const LatencyHistogram &histogram)
+{
+    const LatencyHistogram::Summary summary = histogram.summary();
+    writer.sample("msfs_dashboard_latency_seconds", summary.p50 / 1e9, "stage", stage, "quantile", "0.5");
+    writer.sample("msfs_dashboard_latency_seconds", summary.p99 / 1e9, "stage", stage, "quantile", "0.99");
+    writer.sample("msfs_dashboard_latency_seconds", summary.max / 1e9, "stage", stage, "quantile", "1");
+    writer.sample("msfs_dashboard_latency_seconds_count", static_cast<double>(summary.count), "stage", stage);
+}
+
+} // namespace
+
+QByteArray Metrics::prometheusText() const
+{
+    PrometheusWriter writer;
+
+    writer.family("msfs_dashboard_simconnect_messages_total", "counter", "SimConnect messages received, by SIMCONNECT_RECV_ID.");
+    for (int id = 0; id < MaxSimConnectMessageTypes; ++id) {
+        if (std::uint64_t value = load(m_simconnect_messages[id])) {
+            const char *name = m_simconnect_message_names[id].load(std::memory_order_relaxed);
+            writer.sample("msfs_dashboard_simconnect_messages_total", static_cast<double>(value),
+                          "type", name ? QByteArray(name) : "RECV_ID_" + QByteArray::number(id));
+        }
+    }
+
+    writer.family("msfs_dashboard_sim_frames_total", "counter", "Telemetry snapshots received by the UI.");
+    writer.sample("msfs_dashboard_sim_frames_total", static_cast<double>(load(simFrames)));
+    writer.family("msfs_dashboard_displayed_frames_total", "counter", "Snapshots applied to the instruments.");
+    writer.sample("msfs_dashboard_displayed_frames_total", static_cast<double>(load(displayedFrames)));
+    writer.family("msfs_dashboard_coalesced_frames_total", "counter", "Snapshots superseded before the next display refresh.");
+    writer.sample("msfs_dashboard_coalesced_frames_total", static_cast<double>(load(coalescedFrames)));
+    writer.family("msfs_dashboard_predicted_frames_total", "counter", "Display refreshes showing a prediction without a new snapshot.");
+    writer.sample("msfs_dashboard_predicted_frames_total", static_cast<double>(load(predictedFrames)));
+
+    const QMetaEnum events = QMetaEnum::fromType<TelemetrySource::EVENT_ID>();
+    writer.family("msfs_dashboard_events_transmitted_total", "counter", "Client events sent to the sim.");
+    for (int id = 0; id < MaxEventIds; ++id) {
+        if (std::uint64_t value = load(m_events_transmitted[id])) {
+            writer.sample("msfs_dashboard_events_transmitted_total", static_cast<double>(value), "event", events.valueToKey(id));
+        }
+    }
+    writer.family("msfs_dashboard_events_failed_total", "counter", "Client events that could not be sent.");
+    for (int id = 0; id < MaxEventIds; ++id) {
+        if (std::uint64_t value = load(m_events_failed[id])) {
+            writer.sample("msfs_dashboard_events_failed_total", static_cast<double>(value), "event", events.valueToKey(id));
+        }
+    }
+
+    writer.family("msfs_dashboard_commands_total", "counter", "Client events submitted to the command pipeline, by outcome.");
+    writer.sample("msfs_dashboard_commands_total", static_cast<double>(load(commandsSubmitted)), "outcome", "submitted");
+    writer.sample("msfs_dashboard_commands_total", static_cast<double>(load(commandsCoalesced)), "outcome", "coalesced");
+    writer.sample("msfs_dashboard_commands_total", static_cast<double>(load(commandsRateLimited)), "outcome", "rate_limited");
+    writer.sample("msfs_dashboard_commands_total", static_cast<double>(load(commandsAcknowledged)), "outcome", "acknowledged");
+    writer.sample("msfs_dashboard_commands_total", static_cast<double>(load(commandsTimedOut)), "outcome", "timed_out");
+
+    writer.family("msfs_dashboard_telemetry_clients", "gauge", "Subscribers connected to the telemetry server.");
+    writer.sample("msfs_dashboard_telemetry_clients", static_cast<double>(load(telemetryClients)));
+    writer.family("msfs_dashboard_telemetry_frames_total", "counter", "Telemetry server frames, by outcome.");
+    writer.sample("msfs_dashboard_telemetry_frames_total", static_cast<double>(load(telemetryFramesSent)), "outcome", "sent");
+    writer.sample("msfs_dashboard_telemetry_frames_total", static_cast<double>(load(telemetryFramesDropped)), "outcome", "dropped");
+    writer.family("msfs_dashboard_telemetry_bytes_total", "counter", "Bytes written to telemetry subscribers.");
+    writer.sample("msfs_dashboard_telemetry_bytes_total", static_cast<double>(load(telemetryBytesSent)));
+
+    writer.family("msfs_dashboard_traffic_objects", "gauge", "Aircraft tracked around the own ship.");
+    writer.sample("msfs_dashboard_traffic_objects", static_cast<double>(load(trafficObjects)));
+
+    writer.family("msfs_dashboard_instrument_paint_seconds", "summary", "Instrument paintEvent durations.");
+    {
+        std::lock_guard<std::mutex> lock(m_instruments_mutex);
+        for (const InstrumentPaint &instrument : m_instruments) {
+            writer.sample("msfs_dashboard_instrument_paint_seconds_sum", load(instrument.durationNs) / 1e9, "instrument", instrument.name);
+            writer.sample("msfs_dashboard_instrument_paint_seconds_count", static_cast<double>(load(instrument.count)), "instrument", instrument.name);
+        }
+    }
+
+    const LatencyStats &latency = LatencyStats::instance();
+    writer.family("msfs_dashboard_latency_seconds", "summary", "End-to-end telemetry latency by stage.");
+    writeLatency(writer, "receive_to_slot", latency.receiveToSlot);
+    writeLatency(writer, "slot_to_paint", latency.slotToPaint);
+    writeLatency(writer, "paint", latency.paintDuration);
+    writeLatency(writer, "command_ack", latency.commandAck);
+
+    const std::uint64_t connects = load(m_connects);
+    writer.family("msfs_dashboard_connected", "gauge", "1 while the telemetry source is connected.");
+    writer.sample("msfs_dashboard_connected", m_connected.load(std::memory_order_relaxed) ? 1 : 0);
+    writer.family("msfs_dashboard_connects_total", "counter", "Successful connections to the telemetry source.");
+    writer.sample("msfs_dashboard_connects_total", static_cast<double>(connects));
+    writer.family("msfs_dashboard_reconnects_total", "counter", "Connections after the first one.");
+    writer.sample("msfs_dashboard_reconnects_total", static_cast<double>(connects > 0 ? connects - 1 : 0));
+    writer.family("msfs_dashboard_disconnects_total", "counter", "Disconnections from the telemetry source.");
+    writer.sample("msfs_dashboard_disconnects_total", static_cast<double>(load(m_disconnects)));
+
+    return writer.text();
+}
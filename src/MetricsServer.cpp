@@ -0,0 +1,73 @@
+#include "MetricsServer.h"
+#include <QTcpSocket>
+#include <loguru.hpp>
+#include "Metrics.h"
+
+// Request headers larger than this are not a scraper
+static constexpr qint64 max_request_size = 8192;
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+bool MetricsServer::listen(const QHostAddress &address, quint16 port)
+{
+    if (!m_server.listen(address, port)) {
+        LOG_F(ERROR, "Metrics endpoint cannot listen on %s:%u: %s",
+              qPrintable(address.toString()), port, qPrintable(m_server.errorString()));
+        return false;
+    }
+    LOG_F(INFO, "Serving metrics on http://%s:%u/metrics", qPrintable(address.toString()), m_server.serverPort());
+    if (!address.isLoopback()) {
+        LOG_F(WARNING, "Metrics endpoint is reachable from other hosts");
+    }
+    return true;
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsServer::onReadyRead(QTcpSocket *socket)
+{
+    // Wait for the end of the request headers; the body is never needed
+    QByteArray request = socket->peek(max_request_size);
+    if (!request.contains("\r\n\r\n")) {
+        if (request.size() >= max_request_size) {
+            socket->abort();
+        }
+        return;
+    }
+    socket->readAll();
+
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QByteArray path = requestLine.value(1);
+
+    QByteArray status = "200 OK";
+    QByteArray contentType = "text/plain; version=0.0.4; charset=utf-8";
+    QByteArray body;
+    if ((method == "GET" || method == "HEAD") && (path == "/metrics" || path.startsWith("/metrics?"))) {
+        body = Metrics::instance().prometheusText();
+    } else {
+        status = "404 Not Found";
+        contentType = "text/plain; charset=utf-8";
+        body = "Not found, try /metrics\n";
+    }
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: " + contentType + "\r\n"
+        "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n";
+    if (method != "HEAD") {
+        response += body;
+    }
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,104 @@
+#include "MotionPredictor.h"
+#include <algorithm>
+#include <cmath>
+
+// Fields backing each MotionPredictor::Channel, in enum order
+static float AircraftData::*const channelFields[MotionPredictor::ChannelCount] = {
+    &AircraftData::attitude_bank_degrees,
+    &AircraftData::attitude_pitch_degrees,
+    &AircraftData::plane_heading_degrees_true,
+    &AircraftData::eng_n1_1,
+    &AircraftData::eng_n1_2,
+    &AircraftData::eng_n1_3,
+    &AircraftData::eng_n1_4,
+};
+
+static float wrapDegrees(float degrees)
+{
+    float wrapped = std::fmod(degrees, 360.0f);
+    return wrapped < 0.0f ? wrapped + 360.0f : wrapped;
+}
+
+MotionPredictor::MotionPredictor(std::int64_t horizonNs)
+{
+    setHorizon(horizonNs);
+}
+
+void MotionPredictor::reset()
+{
+    m_latest = AircraftData {};
+    m_latest_ns = 0;
+    m_interval_ns = 0.0;
+    m_sample_count = 0;
+    m_values.fill(0.0f);
+    m_slopes.fill(0.0f);
+}
+
+void MotionPredictor::addSample(const AircraftData &data)
+{
+    const std::int64_t interval = data.received_ns - m_latest_ns;
+    const bool usable = m_sample_count > 0 && interval > 0 && interval <= MaxSampleGapNs;
+    if (usable) {
+        m_interval_ns = m_interval_ns > 0.0 ? m_interval_ns + (interval - m_interval_ns) * 0.25 : interval;
+    }
+
+    const float rate = usable ? static_cast<float>(1e9 / m_interval_ns) : 0.0f;
+    for (std::size_t i = 0; i < ChannelCount; ++i) {
+        const float value = data.*channelFields[i];
+        float delta = value - m_values[i];
+        if (i == Heading) {
+            delta = std::remainder(delta, 360.0f);
+        }
+        m_slopes[i] = delta * rate;
+        m_values[i] = value;
+    }
+
+    m_latest = data;
+    m_latest_ns = data.received_ns;
+    ++m_sample_count;
+}
+
+double MotionPredictor::extrapolationLimitNs() const
+{
+    return std::min(static_cast<double>(m_horizon_ns), m_interval_ns * ExtrapolationIntervals);
+}
+
+bool MotionPredictor::isActive(std::int64_t displayTimeNs) const
+{
+    return m_horizon_ns > 0 && m_sample_count > 1 && m_interval_ns > 0.0
+        && displayTimeNs - m_latest_ns < extrapolationLimitNs() + m_interval_ns;
+}
+
+void MotionPredictor::predictChannels(std::int64_t displayTimeNs, float *values) const
+{
+    // Negative offsets interpolate back towards the previous sample, at most
+    // one interval; positive ones extrapolate up to the limit. Past it the
+    // next sample is overdue, most likely because the values stopped
+    // changing, so the offset shrinks back to zero over one interval.
+    double offsetNs = 0.0;
+    if (m_horizon_ns > 0 && m_interval_ns > 0.0) {
+        const double limitNs = extrapolationLimitNs();
+        offsetNs = std::max(static_cast<double>(displayTimeNs - m_latest_ns), -m_interval_ns);
+        if (offsetNs > limitNs) {
+            const double overdue = (offsetNs - limitNs) / m_interval_ns;
+            offsetNs = overdue < 1.0 ? limitNs * (1.0 - overdue) : 0.0;
+        }
+    }
+    const float offset = static_cast<float>(offsetNs * 1e-9);
+
+    for (std::size_t i = 0; i < ChannelCount; ++i) {
+        values[i] = m_values[i] + m_slopes[i] * offset;
+    }
+    values[Heading] = wrapDegrees(values[Heading]);
+}
+
+AircraftData MotionPredictor::predict(std::int64_t displayTimeNs) const
+{
+    AircraftData data = m_latest;
+    alignas(16) std::array<float, ChannelCount> values;
+    predictChannels(displayTimeNs, values.data());
+    for (std::size_t i = 0; i < ChannelCount; ++i) {
+        data.*channelFields[i] = values[i];
+    }
+    return data;
+}
@@ -0,0 +1,169 @@
+#include "ReadoutRenderer.h"
+#include <QFontMetricsF>
+#include <cmath>
+#include <cstring>
+
+ReadoutRenderer::ReadoutRenderer(const QFont &font, const QColor &color)
+    : m_font(font)
+    , m_color(color)
+{
+    m_glyph_index.fill(-1);
+}
+
+void ReadoutRenderer::rebuild(qreal deviceScale)
+{
+    QFontMetricsF metrics(m_font);
+    int glyphCount = static_cast<int>(std::strlen(glyphSet));
+
+    qreal maxAdvance = 0.0;
+    for (int i = 0; i < glyphCount; ++i) {
+        m_glyph_index[static_cast<unsigned char>(glyphSet[i])] = static_cast<qint8>(i);
+        m_advance[i] = metrics.horizontalAdvance(QChar(glyphSet[i]));
+        maxAdvance = qMax(maxAdvance, m_advance[i]);
+    }
+    m_ascent = metrics.ascent();
+    m_descent = metrics.descent();
+
+    // Cells are padded so antialiased edges and overhangs are not clipped,
+    // and snapped to whole device pixels so glyphs never bleed into each other.
+    m_cell_pixel_width = static_cast<int>(std::ceil((maxAdvance + 2 * m_padding) * deviceScale));
+    m_cell_pixel_height = static_cast<int>(std::ceil((m_ascent + m_descent + 2 * m_padding) * deviceScale));
+    m_cell_width = m_cell_pixel_width / deviceScale;
+    m_cell_height = m_cell_pixel_height / deviceScale;
+
+    m_atlas = QImage(m_cell_pixel_width * glyphCount, m_cell_pixel_height, QImage::Format_ARGB32_Premultiplied);
+    m_atlas.fill(Qt::transparent);
+
+    QPainter painter(&m_atlas);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.scale(deviceScale, deviceScale);
+    painter.setFont(m_font);
+    painter.setPen(m_color);
+    for (int i = 0; i < glyphCount; ++i) {
+        painter.drawText(QPointF(i * m_cell_width + m_padding, m_padding + m_ascent), QString(QChar(glyphSet[i])));
+    }
+}
+
+qreal ReadoutRenderer::textWidth(const char *text, int length) const
+{
+    qreal width = 0.0;
+    for (int i = 0; i < length; ++i) {
+        int index = glyphIndex(text[i]);
+        if (index >= 0) {
+            width += m_advance[index];
+        }
+    }
+    return width;
+}
+
+void ReadoutRenderer::draw(QPainter &painter, const QRectF &rect, Qt::Alignment alignment, const char *text, int length) const
+{
+    qreal width = textWidth(text, length);
+    qreal x = rect.left();
+    if (alignment & Qt::AlignHCenter) {
+        x = rect.center().x() - width / 2.0;
+    } else if (alignment & Qt::AlignRight) {
+        x = rect.right() - width;
+    }
+
+    qreal baseline = rect.top() + m_ascent;
+    if (alignment & Qt::AlignVCenter) {
+        baseline = rect.center().y() - (m_ascent + m_descent) / 2.0 + m_ascent;
+    } else if (alignment & Qt::AlignBottom) {
+        baseline = rect.bottom() - m_descent;
+    }
+
+    drawGlyphs(painter, x, baseline, text, length);
+}
+
+void ReadoutRenderer::draw(QPainter &painter, const QPointF &baseline, const char *text, int length) const
+{
+    drawGlyphs(painter, baseline.x(), baseline.y(), text, length);
+}
+
+void ReadoutRenderer::drawGlyphs(QPainter &painter, qreal x, qreal baseline, const char *text, int length) const
+{
+    if (m_atlas.isNull()) {
+        return;
+    }
+
+    qreal top = baseline - m_ascent - m_padding;
+    for (int i = 0; i < length; ++i) {
+        int index = glyphIndex(text[i]);
+        if (index < 0) {
+            continue;
+        }
+        QRectF target(x - m_padding, top, m_cell_width, m_cell_height);
+        QRectF source(index * m_cell_pixel_width, 0, m_cell_pixel_width, m_cell_pixel_height);
+        painter.drawImage(target, m_atlas, source);
+        x += m_advance[index];
+    }
+}
+
+int ReadoutRenderer::formatFixed(char *buffer, int capacity, double value, int decimals, int zeroPadWidth)
+{
+    static const double scales[] = { 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0 };
+
+    if (capacity <= 0) {
+        return 0;
+    }
+
+    int length = 0;
+    auto put = [&](char c) {
+        if (length < capacity - 1) {
+            buffer[length++] = c;
+        }
+    };
+
+    decimals = qBound(0, decimals, 6);
+    double scaled = std::fabs(value) * scales[decimals] + 0.5;
+    if (!(scaled < 1e15)) {
+        // NaN or out of range: show dashes rather than garbage digits.
+        put('-');
+        put('-');
+        buffer[length] = '\0';
+        return length;
+    }
+
+    unsigned long long units = static_cast<unsigned long long>(scaled);
+    char digits[24];
+    int digitCount = 0;
+    do {
+        digits[digitCount++] = static_cast<char>('0' + units % 10);
+        units /= 10;
+    } while (units != 0 || digitCount <= decimals);
+
+    bool negative = value < 0.0 && digitCount > 0 && std::fabs(value) * scales[decimals] >= 0.5;
+    int integerDigits = digitCount - decimals;
+    int used = (negative ? 1 : 0) + integerDigits + (decimals > 0 ? decimals + 1 : 0);
+
+    if (negative) {
+        put('-');
+    }
+    for (int pad = zeroPadWidth - used; pad > 0; --pad) {
+        put('0');
+    }
+    for (int i = digitCount - 1; i >= decimals; --i) {
+        put(digits[i]);
+    }
+    if (decimals > 0) {
+        put('.');
+        for (int i = decimals - 1; i >= 0; --i) {
+            put(digits[i]);
+        }
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+int ReadoutRenderer::appendText(char *buffer, int length, int capacity, const char *text)
+{
+    while (*text && length < capacity - 1) {
+        buffer[length++] = *text++;
+    }
+    if (capacity > 0) {
+        buffer[length] = '\0';
+    }
+    return length;
+}
@@ -0,0 +1,320 @@
+#include "ReplaySource.h"
+#include <QtMath>
+#include <algorithm>
+#include <loguru.hpp>
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+
+ReplaySource::ReplaySource(QObject *parent)
+    : TelemetrySource(parent)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &ReplaySource::playDue);
+}
+
+bool ReplaySource::open(const QString &path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        LOG_F(ERROR, "Failed to open flight recording %s", qPrintable(path));
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(m_file.size());
+    m_data = m_file.map(0, m_file.size());
+    if (!m_data) {
+        LOG_F(ERROR, "Failed to map flight recording %s", qPrintable(path));
+        return false;
+    }
+
+    std::size_t headerSize = FlightData::readFileHeader(m_data, m_size, m_header);
+    if (headerSize == 0) {
+        LOG_F(ERROR, "%s is not a flight recording", qPrintable(path));
+        return false;
+    }
+
+    // Map recorded columns by name so recordings stay playable when channels change
+    const std::vector<FlightData::Channel> &channels = FlightData::aircraftChannels();
+    m_channel_map.assign(channels.size(), -1);
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        for (std::size_t column = 0; column < m_header.channels.size(); ++column) {
+            if (m_header.channels[column].name == channels[i].name) {
+                m_channel_map[i] = static_cast<int>(column);
+                break;
+            }
+        }
+        if (m_channel_map[i] < 0) {
+            LOG_F(WARNING, "Recording has no channel %s", channels[i].name.c_str());
+        }
+    }
+
+    if (!FlightData::readIndex(m_data, m_size, m_index)) {
+        LOG_F(WARNING, "Recording has no index, scanning chunk headers");
+        buildIndexFromChunks(headerSize);
+    }
+    // Empty chunks have no cursor position; the chunk scan never indexes them
+    m_index.erase(std::remove_if(m_index.begin(), m_index.end(),
+                                 [](const FlightData::IndexEntry &entry) { return entry.sampleCount == 0; }),
+                  m_index.end());
+    if (m_index.empty() || !loadChunk(0)) {
+        LOG_F(ERROR, "Flight recording %s contains no samples", qPrintable(path));
+        return false;
+    }
+
+    LOG_F(INFO, "Opened flight recording %s: %zu chunks, %.1f s",
+          qPrintable(path), m_index.size(), duration() * 1e-6);
+    return true;
+}
+
+bool ReplaySource::buildIndexFromChunks(std::size_t offset)
+{
+    m_index.clear();
+    FlightData::ChunkHeader header;
+    while (FlightData::readChunkHeader(m_data + offset, m_size - offset, header)) {
+        std::size_t end = offset + FlightData::ChunkHeaderSize + header.payloadSize;
+        if (end > m_size || header.sampleCount == 0) {
+            break; // truncated by an interrupted recording
+        }
+        FlightData::IndexEntry entry;
+        entry.firstTimestamp = header.firstTimestamp;
+        entry.lastTimestamp = header.lastTimestamp;
+        entry.offset = offset;
+        entry.sampleCount = header.sampleCount;
+        m_index.push_back(entry);
+        offset = end;
+    }
+    return !m_index.empty();
+}
+
+bool ReplaySource::loadChunk(std::size_t chunk)
+{
+    if (chunk == m_chunk) {
+        return true;
+    }
+
+    const FlightData::IndexEntry &entry = m_index[chunk];
+    FlightData::ChunkHeader header;
+    if (entry.offset >= m_size
+        || !FlightData::readChunkHeader(m_data + entry.offset, m_size - entry.offset, header)
+        || FlightData::ChunkHeaderSize + std::uint64_t(header.payloadSize) > m_size - entry.offset
+        || header.sampleCount == 0 || header.sampleCount > m_header.chunkCapacity
+        || header.sampleCount != entry.sampleCount) {
+        LOG_F(ERROR, "Corrupt chunk %zu in flight recording", chunk);
+        return false;
+    }
+
+    const std::uint8_t *payload = m_data + entry.offset + FlightData::ChunkHeaderSize;
+    if (!FlightData::decodeChunkPayload(payload, header.payloadSize, header, m_header.channels, m_timestamps, m_values)
+        || m_timestamps.empty()) {
+        LOG_F(ERROR, "Failed to decode chunk %zu in flight recording", chunk);
+        return false;
+    }
+
+    m_chunk = chunk;
+    m_sample = 0;
+    return true;
+}
+
+bool ReplaySource::isConnected() const
+{
+    return m_connected;
+}
+
+qint64 ReplaySource::duration() const
+{
+    return m_index.empty() ? 0 : m_index.back().lastTimestamp;
+}
+
+qint64 ReplaySource::position() const
+{
+    if (!m_connected) {
+        return m_start_position;
+    }
+    return m_paused || atEnd() ? m_anchor_media_time : mediaTime();
+}
+
+void ReplaySource::connectToSim()
+{
+    if (m_connected) {
+        return;
+    }
+    if (m_index.empty()) {
+        LOG_F(WARNING, "Cannot start replay - no flight recording loaded");
+        return;
+    }
+
+    m_connected = true;
+    LOG_F(INFO, "Replay started at %.1f s, speed %.2fx", m_start_position * 1e-6, m_speed);
+    emit connected();
+    seek(m_start_position);
+}
+
+void ReplaySource::disconnectFromSim()
+{
+    if (m_connected) {
+        m_timer.stop();
+        m_connected = false;
+        LOG_F(INFO, "Replay stopped at %.1f s", position() * 1e-6);
+        emit disconnected();
+    }
+}
+
+void ReplaySource::transmitEvent(EVENT_ID eventId, quint32 data)
+{
+    // Recorded flights are read-only
+    VLOG_F(1, "Replay ignores event: ID=%d, data=%u", static_cast<int>(eventId), data);
+    Metrics::instance().countEventFailed(eventId);
+}
+
+void ReplaySource::setSpeed(double speed)
+{
+    speed = qBound(0.01, speed, 1000.0);
+    if (m_connected && !m_paused) {
+        restartClock(mediaTime());
+    }
+    m_speed = speed;
+    if (m_connected && !m_paused) {
+        scheduleNext();
+    }
+    LOG_F(INFO, "Replay speed %.2fx", m_speed);
+}
+
+void ReplaySource::setPaused(bool paused)
+{
+    if (paused == m_paused) {
+        return;
+    }
+
+    if (m_connected) {
+        if (paused) {
+            m_anchor_media_time = mediaTime();
+            m_timer.stop();
+        } else if (atEnd()) {
+            m_paused = false;
+            seek(0); // resuming at the end starts over
+            return;
+        } else {
+            restartClock(m_anchor_media_time);
+        }
+    }
+    m_paused = paused;
+    if (m_connected && !m_paused) {
+        scheduleNext();
+    }
+    VLOG_F(1, "Replay %s", m_paused ? "paused" : "resumed");
+}
+
+void ReplaySource::stepFrame()
+{
+    setPaused(true);
+    if (m_connected && !atEnd()) {
+        m_anchor_media_time = cursorTimestamp();
+        emitCursorSample();
+    }
+}
+
+void ReplaySource::seek(qint64 timestamp)
+{
+    if (m_index.empty()) {
+        return;
+    }
+    if (!m_connected) {
+        m_start_position = timestamp;
+        return;
+    }
+
+    // First chunk that ends at or after the timestamp, then the first sample at or after it
+    auto chunk = std::lower_bound(m_index.begin(), m_index.end(), timestamp,
+                                  [](const FlightData::IndexEntry &entry, qint64 value) { return entry.lastTimestamp < value; });
+    if (chunk == m_index.end()) {
+        --chunk;
+    }
+    if (!loadChunk(static_cast<std::size_t>(chunk - m_index.begin()))) {
+        disconnectFromSim();
+        return;
+    }
+    m_sample = static_cast<std::size_t>(std::lower_bound(m_timestamps.begin(), m_timestamps.end(), timestamp) - m_timestamps.begin());
+    m_sample = std::min(m_sample, m_timestamps.size() - 1);
+
+    // Show the sample at the new position right away, also while paused
+    qint64 target = cursorTimestamp();
+    emitCursorSample();
+    restartClock(target);
+    if (!m_paused) {
+        scheduleNext();
+    }
+}
+
+void ReplaySource::playDue()
+{
+    if (!m_connected || m_paused) {
+        return;
+    }
+
+    qint64 now = mediaTime();
+    // Never fall more than a second of wall time behind after a stall
+    if (!atEnd() && now - cursorTimestamp() > static_cast<qint64>(1000000 * m_speed)) {
+        restartClock(cursorTimestamp());
+        now = cursorTimestamp();
+    }
+    while (!atEnd() && cursorTimestamp() <= now) {
+        emitCursorSample();
+    }
+
+    if (atEnd()) {
+        m_anchor_media_time = duration();
+        m_paused = true;
+        LOG_F(INFO, "Replay reached the end of the recording");
+        return;
+    }
+    scheduleNext();
+}
+
+bool ReplaySource::atEnd() const
+{
+    return m_sample >= m_timestamps.size();
+}
+
+void ReplaySource::emitCursorSample()
+{
+    const std::size_t columns = m_header.channels.size();
+    const double *row = &m_values[m_sample * columns];
+    double values[AircraftSchema::FieldCount] = {};
+    for (std::size_t i = 0; i < m_channel_map.size(); ++i) {
+        if (m_channel_map[i] >= 0) {
+            values[i] = row[m_channel_map[i]];
+        }
+    }
+
+    AircraftData data {};
+    FlightData::fromChannels(values, data);
+    data.received_ns = data.published_ns = LatencyHistogram::now();
+
+    ++m_sample;
+    if (atEnd() && m_chunk + 1 < m_index.size()) {
+        loadChunk(m_chunk + 1);
+    }
+    emit snapshotDecoded(data);
+    emit aircraftDataUpdated(data);
+}
+
+void ReplaySource::restartClock(qint64 mediaTime)
+{
+    m_anchor_media_time = mediaTime;
+    m_clock.start();
+}
+
+qint64 ReplaySource::mediaTime() const
+{
+    return m_anchor_media_time + static_cast<qint64>(m_clock.nsecsElapsed() / 1000 * m_speed);
+}
+
+void ReplaySource::scheduleNext()
+{
+    if (atEnd()) {
+        return;
+    }
+    qint64 wait = cursorTimestamp() - mediaTime();
+    m_timer.start(qMax(0, qCeil(wait / 1000.0 / m_speed)));
+}
@@ -1,64 +1,143 @@
 #include "RpmIndicator.h"
 #include <QPainter>
+#include <cmath>
 
-RpmIndicator::RpmIndicator(QWidget *parent) : QWidget(parent)
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const QRectF rpmTextRect(-40, -20, 80, 20);
+static const QRectF throttleTextRect(-40, 5, 80, 20);
+
+// Readouts show one decimal, so compare values at that precision.
+static long long displayedTenths(float percent)
+{
+    return std::llround(percent * 10.0);
+}
+
+// Bounding box of the part of the RPM arc that changes between two values.
+static QRectF arcDirtyRect(float fromPercent, float toPercent)
+{
+    const qreal radius = 45.0;
+    const qreal margin = 3.0; // half the pen width plus antialiasing
+    const QRectF fullDial(-radius - margin, -radius - margin, 2 * (radius + margin), 2 * (radius + margin));
+
+    qreal from = qMin(fromPercent, toPercent) * 3.6;
+    qreal to = qMax(fromPercent, toPercent) * 3.6;
+    if (from < 0.0 || to > 360.0) {
+        return fullDial;
+    }
+
+    // Arc runs clockwise from 12 o'clock; include the endpoints and any
+    // quadrant extremes the swept segment crosses.
+    auto pointAt = [radius](qreal degrees) {
+        qreal radians = degrees * M_PI / 180.0;
+        return QPointF(radius * std::sin(radians), -radius * std::cos(radians));
+    };
+    QPointF start = pointAt(from);
+    QPointF end = pointAt(to);
+    qreal left = qMin(start.x(), end.x());
+    qreal right = qMax(start.x(), end.x());
+    qreal top = qMin(start.y(), end.y());
+    qreal bottom = qMax(start.y(), end.y());
+    if (from < 90.0 && to > 90.0) right = radius;
+    if (from < 180.0 && to > 180.0) bottom = radius;
+    if (from < 270.0 && to > 270.0) left = -radius;
+
+    return QRectF(QPointF(left, top), QPointF(right, bottom)).adjusted(-margin, -margin, margin, margin);
+}
+
+RpmIndicator::RpmIndicator(QWidget *parent)
+    : InstrumentWidget(100.0, parent)
+    , m_rpm_readout(QFont("Arial", 10, QFont::Bold), Qt::black)
+    , m_throttle_readout(QFont("Arial", 8), Qt::black)
 {
     setMinimumSize(100, 100);
+    setChangeThreshold(0.1f); // percent
 }
 
 void RpmIndicator::setTitle(const QString &title)
 {
     m_title = title;
+    invalidateStaticLayers();
+    updateInstrument();
 }
 
 void RpmIndicator::setRpmPercent(float rpm)
 {
+    bool arcChanged = exceedsThreshold(m_arc_rpm_percent, rpm);
+    bool textChanged = displayedTenths(rpm) != displayedTenths(m_rpm_percent);
+    if (!arcChanged && !textChanged) {
+        countSuppressedRepaint();
+        return;
+    }
+
+    if (arcChanged) {
+        updateLogicalRect(arcDirtyRect(m_arc_rpm_percent, rpm));
+        m_arc_rpm_percent = rpm;
+    }
+    if (textChanged) {
+        updateLogicalRect(rpmTextRect);
+    }
     m_rpm_percent = rpm;
-    update();
 }
 
 void RpmIndicator::setThrottlePercent(float throttle)
 {
+    // Throttle is only shown as text
+    if (displayedTenths(throttle) == displayedTenths(m_throttle_percent)) {
+        countSuppressedRepaint();
+        return;
+    }
     m_throttle_percent = throttle;
-    update();
+    updateLogicalRect(throttleTextRect);
 }
 
-void RpmIndicator::paintEvent(QPaintEvent *event)
+void RpmIndicator::captureRenderState()
 {
-    Q_UNUSED(event);
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    m_render_rpm_percent = m_rpm_percent;
+    m_render_throttle_percent = m_throttle_percent;
+    m_render_arc_rpm_percent = m_arc_rpm_percent;
+    m_render_title = m_title;
+}
 
-    int side = qMin(width(), height());
-    painter.save();
-    painter.translate(width() / 2.0, height() / 2.0);
-    painter.scale(side / 100.0, side / 100.0);
+void RpmIndicator::staticLayersRebuilt()
+{
+    m_rpm_readout.rebuild(deviceScale());
+    m_throttle_readout.rebuild(deviceScale());
+}
 
+void RpmIndicator::drawStaticBackground(QPainter &painter)
+{
     // Background
     painter.setPen(QPen(QColor(50, 50, 50), 4));
     painter.drawEllipse(QPointF(0, 0), 45, 45);
 
+    // Title (e.g., "ENG 1")
+    painter.setPen(Qt::black);
+    painter.setFont(QFont("Arial", 8));
+    painter.drawText(QRectF(-40, -45, 80, 20), Qt::AlignCenter, m_render_title);
+}
+
+void RpmIndicator::drawDynamicLayer(QPainter &painter)
+{
     // RPM Arc
     QPen arcPen(Qt::green, 4);
     painter.setPen(arcPen);
     int startAngle = 90 * 16;
-    int spanAngle = -static_cast<int>(m_rpm_percent / 100.0f * 360.0f * 16.0f);
+    int spanAngle = -static_cast<int>(m_render_arc_rpm_percent / 100.0f * 360.0f * 16.0f);
     painter.drawArc(QRectF(-45, -45, 90, 90), startAngle, spanAngle);
 
-    // Title (e.g., "ENG 1")
-    painter.setPen(Qt::black);
-    painter.setFont(QFont("Arial", 8));
-    painter.drawText(QRectF(-40, -45, 80, 20), Qt::AlignCenter, m_title);
+    char text[16];
 
     // RPM Percentage Text
-    painter.setPen(Qt::black);
-    painter.setFont(QFont("Arial", 10, QFont::Bold));
-    painter.drawText(QRectF(-40, -20, 80, 20), Qt::AlignCenter, QString::number(m_rpm_percent, 'f', 1) + "%");
+    int length = ReadoutRenderer::formatFixed(text, sizeof(text), m_render_rpm_percent, 1);
+    length = ReadoutRenderer::appendText(text, length, sizeof(text), "%");
+    m_rpm_readout.draw(painter, rpmTextRect, Qt::AlignCenter, text, length);
 
     // Throttle Percentage Text
-    painter.setPen(Qt::black);
-    painter.setFont(QFont("Arial", 8));
-    painter.drawText(QRectF(-40, 5, 80, 20), Qt::AlignCenter, "T: " + QString::number(m_throttle_percent, 'f', 1) + "%");
-
-    painter.restore();
-} 
\ No newline at end of file
+    length = ReadoutRenderer::appendText(text, 0, sizeof(text), "T: ");
+    length += ReadoutRenderer::formatFixed(text + length, static_cast<int>(sizeof(text)) - length, m_render_throttle_percent, 1);
+    length = ReadoutRenderer::appendText(text, length, sizeof(text), "%");
+    m_throttle_readout.draw(painter, throttleTextRect, Qt::AlignCenter, text, length);
+}
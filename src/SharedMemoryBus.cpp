@@ -0,0 +1,64 @@
+#include "SharedMemoryBus.h"
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <loguru.hpp>
+
+// The C layout is written by hand, so check it field by field against the schema
+#define SHM_CHECK_FIELD(type, field, simVar, unit, group, epsilon) \
+    static_assert(offsetof(msfs_telemetry_data, field) == offsetof(AircraftData, field), \
+                  #field " is out of place in msfs_telemetry_data"); \
+    static_assert(std::is_same<decltype(msfs_telemetry_data::field), type>::value, \
+                  #field " has a different type in msfs_telemetry_data");
+AIRCRAFT_DATA_FIELDS(SHM_CHECK_FIELD)
+#undef SHM_CHECK_FIELD
+static_assert(sizeof(msfs_telemetry_data) == AircraftSchema::PayloadSize,
+              "msfs_telemetry_data must list exactly the schema fields");
+
+SharedMemoryBus::SharedMemoryBus(QObject *parent)
+    : QObject(parent)
+{
+    m_mapping.fd = -1;
+}
+
+SharedMemoryBus::~SharedMemoryBus()
+{
+    close();
+}
+
+bool SharedMemoryBus::open(const QString &name)
+{
+    close();
+    const QByteArray encodedName = name.toUtf8();
+    const int result = msfs_telemetry_create(encodedName.constData(), &m_mapping);
+    if (result == MSFS_TELEMETRY_IN_USE) {
+        LOG_F(ERROR, "Shared-memory telemetry region %s is in use by another running dashboard", encodedName.constData());
+        return false;
+    }
+    if (result != MSFS_TELEMETRY_OK) {
+        LOG_F(ERROR, "Cannot create shared-memory telemetry region %s", encodedName.constData());
+        return false;
+    }
+    LOG_F(INFO, "Publishing telemetry to shared memory %s (%zu bytes)", m_mapping.name, m_mapping.size);
+    return true;
+}
+
+void SharedMemoryBus::close()
+{
+    if (m_mapping.shm) {
+        msfs_telemetry_close(&m_mapping);
+    }
+}
+
+void SharedMemoryBus::publish(const AircraftData &data)
+{
+    if (!m_mapping.shm) {
+        return;
+    }
+    msfs_telemetry_frame frame;
+    frame.received_ns = data.received_ns;
+    frame.published_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::memcpy(&frame.data, &data, sizeof(frame.data));
+    msfs_telemetry_write(m_mapping.shm, &frame);
+}
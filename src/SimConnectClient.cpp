@@ -1,10 +1,34 @@
 #include "SimConnectClient.h"
+#include <cstddef>
+#include <cstring>
 #include <loguru.hpp>
+#include "LatencyStats.h"
+#include "Metrics.h"
+#include "Trace.h"
 
-SimConnectClient::SimConnectClient(QObject *parent) : QObject(parent)
+// Traffic is swept within this radius (SimConnect allows up to 200 km) ...
+static constexpr DWORD traffic_radius_meters = 40 * 1852;
+// ... a few times a second, which is plenty for a traffic display
+static constexpr std::int64_t traffic_sweep_interval_ns = 250000000;
+// A sweep that never completed (e.g. the sim dropped it) is abandoned
+static constexpr std::int64_t traffic_sweep_timeout_ns = 5000000000;
+
+// The traffic definition's FLOAT64 datums are added in TrafficSample order
+static_assert(sizeof(TrafficSample) == 6 * sizeof(double), "TrafficSample must match the traffic data definition");
+
+SimConnectClient::SimConnectClient(QObject *parent) : TelemetrySource(parent)
 {
-    processTimer = new QTimer(this);
-    connect(processTimer, &QTimer::timeout, this, &SimConnectClient::processSimConnectEvents);
+    registerSimVars();
+
+    // Labels for the message types dispatchProc handles; others are counted by ID
+    Metrics &metrics = Metrics::instance();
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_NULL, "NULL");
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_EXCEPTION, "EXCEPTION");
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_OPEN, "OPEN");
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_QUIT, "QUIT");
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_EVENT, "EVENT");
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_SIMOBJECT_DATA, "SIMOBJECT_DATA");
+    metrics.setSimConnectMessageName(SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE, "SIMOBJECT_DATA_BYTYPE");
 }
 
 SimConnectClient::~SimConnectClient()
@@ -17,21 +41,48 @@ bool SimConnectClient::isConnected() const
     return hSimConnect != nullptr;
 }
 
+bool SimConnectClient::latestAircraftData(AircraftData &data) const
+{
+    return m_latestData.load(data);
+}
+
 void SimConnectClient::connectToSim()
 {
-    if (SUCCEEDED(SimConnect_Open(&hSimConnect, "MSFS Dashboard", nullptr, 0, 0, 0)))
+    if (hSimConnect)
+    {
+        return;
+    }
+
+    // Auto-reset event SimConnect signals when messages arrive
+    hSimConnectEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+    HANDLE handle = nullptr;
+    if (SUCCEEDED(SimConnect_Open(&handle, "MSFS Dashboard", nullptr, 0, hSimConnectEvent, 0)))
     {
         LOG_F(INFO, "Connected to MSFS.");
-        emit connected();
 
-        setupDataRequests();
-        setupEvents();
+        // Changed-only requests start with a full update
+        m_simVars.resetState();
+        m_trafficSweepPending = false;
+        m_nextTrafficSweepNs = 0;
+        m_ownshipObjectId = SIMCONNECT_OBJECT_ID_USER;
+
+        {
+            // Commands may be sent as soon as the handle is visible
+            std::lock_guard<std::mutex> lock(m_simConnectMutex);
+            hSimConnect = handle;
+            setupDataRequests();
+            setupEvents();
+        }
+        emit connected();
 
-        processTimer->start(16); // ~60 FPS
+        startDispatchThread();
     }
     else
     {
         LOG_F(ERROR, "Failed to connect to MSFS.");
+        CloseHandle(hSimConnectEvent);
+        hSimConnectEvent = nullptr;
     }
 }
 
@@ -39,50 +90,207 @@ void SimConnectClient::disconnectFromSim()
 {
     if (hSimConnect)
     {
-        processTimer->stop();
-        SimConnect_Close(hSimConnect);
-        hSimConnect = nullptr;
+        stopDispatchThread();
+        LOG_F(INFO, "SimVar updates - messages: %llu, values: %llu",
+              m_simVars.messagesDecoded(), m_simVars.valuesDecoded());
+        for (const SimVarRegistry::Group &group : m_simVars.groups())
+        {
+            LOG_F(INFO, "SimVar group %s - messages: %llu, values: %llu", group.name, group.messages, group.values);
+        }
+        {
+            // transmitEvent may run on the command pipeline thread
+            std::lock_guard<std::mutex> lock(m_simConnectMutex);
+            SimConnect_Close(hSimConnect);
+            hSimConnect = nullptr;
+        }
+        CloseHandle(hSimConnectEvent);
+        hSimConnectEvent = nullptr;
         LOG_F(INFO, "Disconnected from MSFS.");
         emit disconnected();
     }
 }
 
-void SimConnectClient::processSimConnectEvents()
+void SimConnectClient::startDispatchThread()
+{
+    m_dispatchRunning.store(true, std::memory_order_release);
+    m_dispatchThread = QThread::create([this] { dispatchLoop(); });
+    m_dispatchThread->setObjectName("SimConnectDispatch");
+    m_dispatchThread->start(QThread::TimeCriticalPriority);
+}
+
+void SimConnectClient::stopDispatchThread()
+{
+    if (!m_dispatchThread)
+    {
+        return;
+    }
+    m_dispatchRunning.store(false, std::memory_order_release);
+    SetEvent(hSimConnectEvent); // wake the thread so it sees the stop request
+    m_dispatchThread->wait();
+    delete m_dispatchThread;
+    m_dispatchThread = nullptr;
+    m_notifyPending.store(false, std::memory_order_release);
+}
+
+void SimConnectClient::dispatchLoop()
 {
-    if(hSimConnect)
+    loguru::set_thread_name("SimConnect I/O");
+    LOG_F(INFO, "SimConnect dispatch thread started");
+
+    while (m_dispatchRunning.load(std::memory_order_acquire))
     {
+        // The timeout is only a safety net; normally the event wakes us
+        WaitForSingleObject(hSimConnectEvent, 100);
+        if (!m_dispatchRunning.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(m_simConnectMutex);
+        TRACE_SCOPE("SimConnect_CallDispatch");
         SimConnect_CallDispatch(hSimConnect, dispatchProc, this);
+
+        const std::int64_t now = LatencyHistogram::now();
+        if (now >= m_nextTrafficSweepNs
+            && (!m_trafficSweepPending || now - m_trafficBatch.timeNs > traffic_sweep_timeout_ns))
+        {
+            requestTrafficSweep(now);
+        }
+    }
+
+    LOG_F(INFO, "SimConnect dispatch thread stopped");
+}
+
+void SimConnectClient::publishAircraftData(const AircraftData &state, std::int64_t receivedNs)
+{
+    // Called on the dispatch thread
+    AircraftData data = state;
+    data.received_ns = receivedNs;
+    data.published_ns = LatencyHistogram::now();
+    LatencyStats::instance().receiveToSlot.record(data.published_ns - data.received_ns);
+    emit snapshotDecoded(data);
+    m_latestData.publish(data);
+    if (!m_notifyPending.exchange(true, std::memory_order_acq_rel))
+    {
+        QMetaObject::invokeMethod(this, [this] { deliverLatestAircraftData(); }, Qt::QueuedConnection);
+    }
+}
+
+void SimConnectClient::requestTrafficSweep(std::int64_t nowNs)
+{
+    // Called on the dispatch thread with m_simConnectMutex held. The own
+    // ship is requested first, so its object ID is known before the sweep.
+    SimConnect_RequestDataOnSimObject(hSimConnect, TRAFFIC_OWNSHIP_REQUEST_ID, TRAFFIC_DEFINITION_ID, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_ONCE);
+    SimConnect_RequestDataOnSimObjectType(hSimConnect, TRAFFIC_REQUEST_ID, TRAFFIC_DEFINITION_ID, traffic_radius_meters, SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT);
+
+    m_trafficBatch.timeNs = nowNs;
+    m_trafficBatch.hasOwnship = false;
+    m_trafficBatch.objectIds.clear();
+    m_trafficBatch.samples.clear();
+    m_trafficBatch.completeSweep = false;
+    m_trafficSweepPending = true;
+    m_nextTrafficSweepNs = nowNs + traffic_sweep_interval_ns;
+}
+
+void SimConnectClient::receiveTrafficEntry(const SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE *entry, DWORD cbData)
+{
+    // Called on the dispatch thread. An empty sweep is a single entry 0 of 0.
+    const std::size_t header = offsetof(SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE, dwData);
+    if (entry->dwoutof > 0 && entry->dwObjectID != m_ownshipObjectId && cbData >= header + sizeof(TrafficSample))
+    {
+        TrafficSample sample;
+        std::memcpy(&sample, &entry->dwData, sizeof(sample));
+        m_trafficBatch.objectIds.push_back(entry->dwObjectID);
+        m_trafficBatch.samples.push_back(sample);
+    }
+
+    if (m_trafficSweepPending && entry->dwentrynumber >= entry->dwoutof)
+    {
+        m_trafficSweepPending = false;
+        m_trafficBatch.completeSweep = true;
+        VLOG_F(2, "Traffic sweep complete: %zu aircraft", m_trafficBatch.objectIds.size());
+        emit trafficUpdated(m_trafficBatch);
     }
 }
 
-void SimConnectClient::transmitEvent(EVENT_ID eventId, DWORD data)
+void SimConnectClient::deliverLatestAircraftData()
 {
+    // Clear the flag before reading so a value published meanwhile queues a
+    // new notification instead of being lost.
+    m_notifyPending.store(false, std::memory_order_release);
+
+    AircraftData data;
+    if (hSimConnect && m_latestData.load(data))
+    {
+        emit aircraftDataUpdated(data);
+    }
+}
+
+void SimConnectClient::transmitEvent(EVENT_ID eventId, quint32 data)
+{
+    // Called from the command pipeline thread
+    std::lock_guard<std::mutex> lock(m_simConnectMutex);
     if (hSimConnect)
     {
-        VLOG_F(1, "Transmitting SimConnect event: ID=%d, data=%lu", static_cast<int>(eventId), data);
-        SimConnect_TransmitClientEvent(hSimConnect, SIMCONNECT_OBJECT_ID_USER, eventId, data, SIMCONNECT_GROUP_PRIORITY_HIGHEST, SIMCONNECT_EVENT_FLAG_GROUPID_IS_PRIORITY);
+        VLOG_F(1, "Transmitting SimConnect event: ID=%d, data=%u", static_cast<int>(eventId), data);
+        if (SUCCEEDED(SimConnect_TransmitClientEvent(hSimConnect, SIMCONNECT_OBJECT_ID_USER, eventId, data, SIMCONNECT_GROUP_PRIORITY_HIGHEST, SIMCONNECT_EVENT_FLAG_GROUPID_IS_PRIORITY)))
+        {
+            Metrics::instance().countEventTransmitted(eventId);
+        }
+        else
+        {
+            Metrics::instance().countEventFailed(eventId);
+        }
     }
     else
     {
         LOG_F(WARNING, "Cannot transmit event - SimConnect not connected");
+        Metrics::instance().countEventFailed(eventId);
     }
 }
 
 void CALLBACK SimConnectClient::dispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext)
 {
     SimConnectClient* client = static_cast<SimConnectClient*>(pContext);
+    Metrics::instance().countSimConnectMessage(pData->dwID);
 
     switch (pData->dwID)
     {
         case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
         {
             SIMCONNECT_RECV_SIMOBJECT_DATA* pObjData = (SIMCONNECT_RECV_SIMOBJECT_DATA*)pData;
+            const std::int64_t receivedNs = LatencyHistogram::now();
+
+            const DWORD firstGroup = groupRequestId(0);
+            if (pObjData->dwRequestID >= firstGroup && pObjData->dwRequestID < firstGroup + client->m_simVars.groups().size())
+            {
+                // Tagged payload: only the SimVars of this group that changed since its last message.
+                // All groups update the same state, so every snapshot is complete.
+                const int group = static_cast<int>(pObjData->dwRequestID - firstGroup);
+                const std::size_t header = offsetof(SIMCONNECT_RECV_SIMOBJECT_DATA, dwData);
+                const std::uint8_t *payload = reinterpret_cast<const std::uint8_t *>(&pObjData->dwData);
+                int changed = client->m_simVars.applyTagged(group, payload, cbData > header ? cbData - header : 0, pObjData->dwDefineCount);
+                VLOG_F(3, "Received %s group update: %lu values, %d changed", client->m_simVars.groups()[group].name, pObjData->dwDefineCount, changed);
+                if (changed > 0)
+                {
+                    client->publishAircraftData(client->m_simVars.state(), receivedNs);
+                }
+            }
+            else if (pObjData->dwRequestID == TRAFFIC_OWNSHIP_REQUEST_ID && cbData >= offsetof(SIMCONNECT_RECV_SIMOBJECT_DATA, dwData) + sizeof(TrafficSample))
+            {
+                client->m_ownshipObjectId = pObjData->dwObjectID;
+                std::memcpy(&client->m_trafficBatch.ownship, &pObjData->dwData, sizeof(TrafficSample));
+                client->m_trafficBatch.hasOwnship = true;
+            }
+            break;
+        }
 
-            if (pObjData->dwRequestID == static_cast<DWORD>(REQUEST_ID::AIRCRAFT_DATA))
+        case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE:
+        {
+            SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE* pObjData = (SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE*)pData;
+            if (pObjData->dwRequestID == TRAFFIC_REQUEST_ID)
             {
-                AircraftData* pS = (AircraftData*)&pObjData->dwData;
-                VLOG_F(3, "Received aircraft data update");
-                emit client->aircraftDataUpdated(*pS);
+                client->receiveTrafficEntry(pObjData, cbData);
             }
             break;
         }
@@ -90,7 +298,9 @@ void CALLBACK SimConnectClient::dispatchProc(SIMCONNECT_RECV* pData, DWORD cbDat
         case SIMCONNECT_RECV_ID_QUIT:
         {
             LOG_F(INFO, "Received SimConnect quit signal");
-            client->disconnectFromSim();
+            // Runs on the dispatch thread, which disconnectFromSim joins
+            client->m_dispatchRunning.store(false, std::memory_order_release);
+            QMetaObject::invokeMethod(client, &SimConnectClient::disconnectFromSim, Qt::QueuedConnection);
             break;
         }
 
@@ -100,6 +310,34 @@ void CALLBACK SimConnectClient::dispatchProc(SIMCONNECT_RECV* pData, DWORD cbDat
     }
 }
 
+void SimConnectClient::registerSimVars()
+{
+    // Instruments that animate every frame
+    const int fast = m_simVars.addGroup("fast", SimVarRegistry::Period::SimFrame);
+    // Discrete and slow-moving state, every 12th sim frame (~2.5-5 Hz)
+    const int slow = m_simVars.addGroup("slow", SimVarRegistry::Period::SimFrame, 11);
+
+    // Indexed by SimVarGroup; the variables come from the AircraftData schema
+    const int groupIds[2] = { fast, slow };
+    m_simVars.addAircraftSchema(groupIds);
+}
+
+static SIMCONNECT_PERIOD toSimConnectPeriod(SimVarRegistry::Period period)
+{
+    switch (period)
+    {
+        case SimVarRegistry::Period::VisualFrame: return SIMCONNECT_PERIOD_VISUAL_FRAME;
+        case SimVarRegistry::Period::SimFrame: return SIMCONNECT_PERIOD_SIM_FRAME;
+        case SimVarRegistry::Period::Second: return SIMCONNECT_PERIOD_SECOND;
+    }
+    return SIMCONNECT_PERIOD_SIM_FRAME;
+}
+
+static SIMCONNECT_DATATYPE toSimConnectDataType(SimVarRegistry::DataType type)
+{
+    return type == SimVarRegistry::DataType::Int32 ? SIMCONNECT_DATATYPE_INT32 : SIMCONNECT_DATATYPE_FLOAT32;
+}
+
 void SimConnectClient::setupDataRequests()
 {
     if (!hSimConnect) {
@@ -109,32 +347,29 @@ void SimConnectClient::setupDataRequests()
     
     LOG_F(INFO, "Setting up SimConnect data requests...");
 
-    // Define the data structure
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR TOTAL PCT EXTENDED", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "BRAKE PARKING INDICATOR", "Bool");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "AUTOPILOT MASTER", "Bool");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "ATTITUDE INDICATOR BANK DEGREES", "Radians");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "ATTITUDE INDICATOR PITCH DEGREES", "Radians");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR HANDLE POSITION", "Bool");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "PLANE HEADING DEGREES TRUE", "Degrees");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR DAMAGE BY SPEED", "Bool");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR WARNING:0", "Number");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR WARNING:1", "Number");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR WARNING:2", "Number");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR CENTER POSITION", "Percent Over 100");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR LEFT POSITION", "Percent Over 100");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GEAR RIGHT POSITION", "Percent Over 100");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "TURB ENG N1:1", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "TURB ENG N1:2", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "TURB ENG N1:3", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "TURB ENG N1:4", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GENERAL ENG THROTTLE LEVER POSITION:1", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GENERAL ENG THROTTLE LEVER POSITION:2", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GENERAL ENG THROTTLE LEVER POSITION:3", "Percent");
-    SimConnect_AddToDataDefinition(hSimConnect, static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), "GENERAL ENG THROTTLE LEVER POSITION:4", "Percent");
-
-    // Request data periodically
-    SimConnect_RequestDataOnSimObject(hSimConnect, static_cast<SIMCONNECT_DATA_REQUEST_ID>(REQUEST_ID::AIRCRAFT_DATA), static_cast<SIMCONNECT_DATA_DEFINITION_ID>(DEFINITION_ID::AIRCRAFT_DATA), SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME);
+    // One definition per request group, one tagged datum per registered SimVar
+    const auto &variables = m_simVars.variables();
+    for (std::size_t datumId = 0; datumId < variables.size(); ++datumId)
+    {
+        const SimVarRegistry::Variable &variable = variables[datumId];
+        SimConnect_AddToDataDefinition(hSimConnect, groupDefinitionId(variable.group), variable.name, variable.unit, toSimConnectDataType(variable.type), variable.epsilon, static_cast<DWORD>(datumId));
+    }
+
+    // Each group at its own rate, but only the values that changed
+    const auto &groups = m_simVars.groups();
+    for (std::size_t group = 0; group < groups.size(); ++group)
+    {
+        SimConnect_RequestDataOnSimObject(hSimConnect, groupRequestId(static_cast<int>(group)), groupDefinitionId(static_cast<int>(group)), SIMCONNECT_OBJECT_ID_USER, toSimConnectPeriod(groups[group].period), SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | SIMCONNECT_DATA_REQUEST_FLAG_TAGGED, 0, groups[group].interval);
+    }
+
+    // Traffic, in TrafficSample order; the sweeps are issued by the dispatch loop
+    SimConnect_AddToDataDefinition(hSimConnect, TRAFFIC_DEFINITION_ID, "PLANE LATITUDE", "Degrees", SIMCONNECT_DATATYPE_FLOAT64);
+    SimConnect_AddToDataDefinition(hSimConnect, TRAFFIC_DEFINITION_ID, "PLANE LONGITUDE", "Degrees", SIMCONNECT_DATATYPE_FLOAT64);
+    SimConnect_AddToDataDefinition(hSimConnect, TRAFFIC_DEFINITION_ID, "PLANE ALTITUDE", "Feet", SIMCONNECT_DATATYPE_FLOAT64);
+    SimConnect_AddToDataDefinition(hSimConnect, TRAFFIC_DEFINITION_ID, "GROUND VELOCITY", "Knots", SIMCONNECT_DATATYPE_FLOAT64);
+    // AI aircraft have no GPS track; the heading is close enough for traffic
+    SimConnect_AddToDataDefinition(hSimConnect, TRAFFIC_DEFINITION_ID, "PLANE HEADING DEGREES TRUE", "Degrees", SIMCONNECT_DATATYPE_FLOAT64);
+    SimConnect_AddToDataDefinition(hSimConnect, TRAFFIC_DEFINITION_ID, "VERTICAL SPEED", "Feet per minute", SIMCONNECT_DATATYPE_FLOAT64);
     
     LOG_F(INFO, "SimConnect data requests setup complete");
 }
@@ -0,0 +1,72 @@
+#include "SimVarRegistry.h"
+#include <cstring>
+#include <loguru.hpp>
+
+int SimVarRegistry::addGroup(const char *name, Period period, std::uint32_t interval)
+{
+    m_groups.push_back({ name, period, interval });
+    return static_cast<int>(m_groups.size()) - 1;
+}
+
+int SimVarRegistry::add(int group, const char *name, const char *unit, DataType type, std::size_t offset, float epsilon)
+{
+    m_variables.push_back({ group, name, unit, type, offset, epsilon });
+    return static_cast<int>(m_variables.size()) - 1;
+}
+
+void SimVarRegistry::addAircraftSchema(const int (&groupIds)[2])
+{
+    for (const AircraftSchema::Field &field : AircraftSchema::Fields) {
+        add(groupIds[static_cast<int>(field.group)], field.simVar, field.unit,
+            field.isInteger ? DataType::Int32 : DataType::Float32, field.offset, field.epsilon);
+    }
+}
+
+int SimVarRegistry::applyTagged(int group, const std::uint8_t *data, std::size_t size, std::uint32_t count)
+{
+    // Tagged entries are packed: 4 byte datum ID followed by the 4 byte value
+    constexpr std::size_t entry_size = sizeof(std::uint32_t) + AircraftSchema::FieldSize;
+
+    ++m_messages;
+    Group &stats = m_groups.at(static_cast<std::size_t>(group));
+    ++stats.messages;
+    int changed = 0;
+    unsigned char *state = reinterpret_cast<unsigned char *>(&m_state);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if ((i + 1) * entry_size > size) {
+            LOG_F(WARNING, "Truncated tagged SimConnect data: %u of %u entries", i, count);
+            break;
+        }
+
+        const std::uint8_t *entry = data + i * entry_size;
+        std::uint32_t datumId;
+        std::memcpy(&datumId, entry, sizeof(datumId));
+        if (datumId >= m_variables.size()) {
+            VLOG_F(1, "Ignoring unknown datum ID %u", datumId);
+            continue;
+        }
+
+        ++m_values;
+        ++stats.values;
+        const Variable &variable = m_variables[datumId];
+        unsigned char *slot = state + variable.offset;
+        const std::uint8_t *value = entry + sizeof(datumId);
+        if (std::memcmp(slot, value, AircraftSchema::FieldSize) == 0) {
+            continue;
+        }
+        std::memcpy(slot, value, AircraftSchema::FieldSize);
+        ++changed;
+    }
+    return changed;
+}
+
+void SimVarRegistry::resetState()
+{
+    m_state = AircraftData();
+    m_messages = 0;
+    m_values = 0;
+    for (Group &group : m_groups) {
+        group.messages = 0;
+        group.values = 0;
+    }
+}
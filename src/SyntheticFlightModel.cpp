@@ -0,0 +1,129 @@
+#include "SyntheticFlightModel.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+SyntheticFlightModel::SyntheticFlightModel(std::uint32_t seed)
+{
+    reset(seed);
+}
+
+void SyntheticFlightModel::reset(std::uint32_t seed)
+{
+    m_data = AircraftData {};
+    m_time = 0.0;
+    m_random = seed ? seed : 1;
+    m_roll_noise = 0.0;
+    m_pitch_noise = 0.0;
+    m_heading = 0.0;
+    m_gear_down = true;
+    for (bool &running : m_engine_running) {
+        running = true;
+    }
+    m_data.gear_handle_position = 1;
+    m_data.gear_total_extended_pct = 1.0f;
+    m_data.gear_pos_center = 1.0f;
+    m_data.gear_pos_left = 1.0f;
+    m_data.gear_pos_right = 1.0f;
+    m_data.eng_n1_1 = m_data.eng_n1_2 = m_data.eng_n1_3 = m_data.eng_n1_4 = 60.0f;
+}
+
+double SyntheticFlightModel::noise()
+{
+    // xorshift32, mapped to [-1, 1]
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random / 2147483647.5 - 1.0;
+}
+
+const AircraftData &SyntheticFlightModel::step(double dt)
+{
+    m_time += dt;
+    const double t = m_time;
+
+    // Slow S-turns with a little low-pass filtered turbulence on top
+    double smoothing = std::min(1.0, dt * 4.0);
+    m_roll_noise += (noise() * 2.0 - m_roll_noise) * smoothing;
+    m_pitch_noise += (noise() * 0.8 - m_pitch_noise) * smoothing;
+    double roll_deg = 25.0 * std::sin(2.0 * M_PI * t / 40.0) + m_roll_noise;
+    double pitch_deg = 2.0 + 5.0 * std::sin(2.0 * M_PI * t / 23.0) + m_pitch_noise;
+    m_data.attitude_bank_degrees = static_cast<float>(roll_deg);
+    m_data.attitude_pitch_degrees = static_cast<float>(pitch_deg);
+
+    // Standard-rate turn at 25 deg of bank
+    m_heading = std::fmod(m_heading + 3.0 * roll_deg / 25.0 * dt, 360.0);
+    if (m_heading < 0.0) m_heading += 360.0;
+    m_data.plane_heading_degrees_true = static_cast<float>(m_heading);
+
+    // Circuits between 400 and 5600 ft above ground every five minutes
+    m_data.plane_alt_above_ground = static_cast<float>(3000.0 - 2600.0 * std::cos(2.0 * M_PI * t / 300.0));
+
+    // Throttles wander together, engines spool towards them with a lag
+    float *throttles[4] = { &m_data.throttle_1, &m_data.throttle_2, &m_data.throttle_3, &m_data.throttle_4 };
+    float *n1[4] = { &m_data.eng_n1_1, &m_data.eng_n1_2, &m_data.eng_n1_3, &m_data.eng_n1_4 };
+    double spool = std::min(1.0, dt / 3.0);
+    for (int i = 0; i < 4; ++i) {
+        double throttle = 60.0 + 20.0 * std::sin(2.0 * M_PI * t / 90.0 + i * 0.3);
+        *throttles[i] = static_cast<float>(throttle);
+        double target = m_engine_running[i] ? 20.0 + throttle * 0.8 : 0.0;
+        *n1[i] += static_cast<float>((target - *n1[i]) * spool);
+    }
+
+    // Gear legs travel at 20%/s, staggered slightly
+    double travel = 0.2 * dt;
+    double target = m_gear_down ? 1.0 : 0.0;
+    float *legs[3] = { &m_data.gear_pos_center, &m_data.gear_pos_left, &m_data.gear_pos_right };
+    for (int i = 0; i < 3; ++i) {
+        double legTravel = travel * (1.0 - 0.1 * i);
+        double leg = *legs[i];
+        leg = leg < target ? std::min(target, leg + legTravel) : std::max(target, leg - legTravel);
+        *legs[i] = static_cast<float>(leg);
+    }
+    m_data.gear_total_extended_pct = (m_data.gear_pos_center + m_data.gear_pos_left + m_data.gear_pos_right) / 3.0f;
+    m_data.gear_handle_position = m_gear_down ? 1 : 0;
+
+    // Warn while gear is up at low power, like the real gear horn
+    bool lowPower = m_data.throttle_1 < 45.0f;
+    m_data.gear_warning_center = (!m_gear_down && lowPower) ? 1 : 0;
+    m_data.gear_warning_left = m_data.gear_warning_center;
+    m_data.gear_warning_right = m_data.gear_warning_center;
+    m_data.gear_damage_by_speed = 0;
+
+    return m_data;
+}
+
+void SyntheticFlightModel::applyEvent(TelemetrySource::EVENT_ID eventId, quint32 data)
+{
+    switch (eventId) {
+    case TelemetrySource::EVENT_GEAR_UP:
+        m_gear_down = false;
+        break;
+    case TelemetrySource::EVENT_GEAR_DOWN:
+        m_gear_down = true;
+        break;
+    case TelemetrySource::EVENT_PARKING_BRAKES:
+        m_data.parking_brake_position = m_data.parking_brake_position ? 0 : 1;
+        break;
+    case TelemetrySource::EVENT_AP_MASTER:
+        m_data.autopilot_master = m_data.autopilot_master ? 0 : 1;
+        break;
+    case TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE2_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE3_STARTER:
+    case TelemetrySource::EVENT_TOGGLE_ENGINE4_STARTER:
+        m_engine_running[eventId - TelemetrySource::EVENT_TOGGLE_ENGINE1_STARTER] = true;
+        break;
+    case TelemetrySource::EVENT_ENGINE_AUTO_SHUTDOWN:
+        // The dashboard passes the 1-based engine number as event data
+        if (data >= 1 && data <= 4) {
+            m_engine_running[data - 1] = false;
+        }
+        break;
+    default:
+        break;
+    }
+}
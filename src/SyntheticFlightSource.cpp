@@ -0,0 +1,96 @@
+#include "SyntheticFlightSource.h"
+#include <QThread>
+#include <QtMath>
+#include <loguru.hpp>
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+
+// Traffic sweeps per second of model time, like the SimConnect client
+static constexpr double traffic_rate_hz = 4.0;
+
+SyntheticFlightSource::SyntheticFlightSource(double rateHz, QObject *parent)
+    : TelemetrySource(parent)
+    , m_rate_hz(qBound(1.0, rateHz, 20000.0))
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SyntheticFlightSource::generate);
+}
+
+bool SyntheticFlightSource::isConnected() const
+{
+    return m_connected;
+}
+
+void SyntheticFlightSource::connectToSim()
+{
+    if (m_connected) {
+        return;
+    }
+
+    m_model.reset(1);
+    m_traffic.reset(m_traffic_count, 1);
+    m_traffic_time = 0.0;
+    m_samples = 0;
+    m_scheduled = 0;
+    m_connected = true;
+    LOG_F(INFO, "Synthetic flight source started at %.1f Hz with %d traffic aircraft.", m_rate_hz, m_traffic_count);
+    emit connected();
+
+    // Above 1 kHz several samples are generated per timer tick
+    m_timer.start(qMax(1, qFloor(1000.0 / m_rate_hz)));
+    m_clock.start();
+}
+
+void SyntheticFlightSource::disconnectFromSim()
+{
+    if (m_connected) {
+        m_timer.stop();
+        m_connected = false;
+        LOG_F(INFO, "Synthetic flight source stopped after %llu samples.", m_samples);
+        emit disconnected();
+    }
+}
+
+void SyntheticFlightSource::transmitEvent(EVENT_ID eventId, quint32 data)
+{
+    // The model is only touched on the source's own thread
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, eventId, data]() { transmitEvent(eventId, data); }, Qt::QueuedConnection);
+        return;
+    }
+    if (m_connected) {
+        VLOG_F(1, "Synthetic source event: ID=%d, data=%u", static_cast<int>(eventId), data);
+        m_model.applyEvent(eventId, data);
+        Metrics::instance().countEventTransmitted(eventId);
+    } else {
+        LOG_F(WARNING, "Cannot transmit event - synthetic source not running");
+        Metrics::instance().countEventFailed(eventId);
+    }
+}
+
+void SyntheticFlightSource::generate()
+{
+    // Catch up with the wall clock in fixed steps, so the generated sequence
+    // only depends on the rate and never on timer jitter.
+    const double dt = 1.0 / m_rate_hz;
+    quint64 due = static_cast<quint64>(m_clock.nsecsElapsed() * 1e-9 * m_rate_hz);
+    // Never fall more than a second behind after a stall
+    if (due > m_scheduled + static_cast<quint64>(m_rate_hz)) {
+        m_scheduled = due - static_cast<quint64>(m_rate_hz);
+    }
+    while (m_scheduled < due) {
+        ++m_scheduled;
+        ++m_samples;
+        AircraftData data = m_model.step(dt);
+        data.received_ns = data.published_ns = LatencyHistogram::now();
+        emit snapshotDecoded(data);
+        emit aircraftDataUpdated(data);
+    }
+
+    if (m_traffic_count > 0 && m_model.time() - m_traffic_time >= 1.0 / traffic_rate_hz) {
+        m_traffic.step(m_model.time() - m_traffic_time, m_model.state().plane_heading_degrees_true, m_traffic_batch);
+        m_traffic_time = m_model.time();
+        m_traffic_batch.timeNs = LatencyHistogram::now();
+        emit trafficUpdated(m_traffic_batch);
+    }
+}
@@ -0,0 +1,96 @@
+#include "SyntheticTrafficModel.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Flat-earth offsets are plenty accurate within the traffic radius
+static void advance(TrafficSample &sample, double dt)
+{
+    const double track = sample.trackDeg * M_PI / 180.0;
+    const double distanceNm = sample.groundSpeedKt * dt / 3600.0;
+    sample.latitudeDeg += distanceNm * std::cos(track) / 60.0;
+    sample.longitudeDeg += distanceNm * std::sin(track) / (60.0 * std::cos(sample.latitudeDeg * M_PI / 180.0));
+    sample.altitudeFt += sample.verticalSpeedFpm * dt / 60.0;
+}
+
+static double distanceNm(const TrafficSample &from, const TrafficSample &to)
+{
+    const double dx = std::remainder(to.longitudeDeg - from.longitudeDeg, 360.0) * 60.0 * std::cos(from.latitudeDeg * M_PI / 180.0);
+    const double dy = (to.latitudeDeg - from.latitudeDeg) * 60.0;
+    return std::hypot(dx, dy);
+}
+
+SyntheticTrafficModel::SyntheticTrafficModel(int count, std::uint32_t seed)
+{
+    reset(count, seed);
+}
+
+void SyntheticTrafficModel::reset(int count, std::uint32_t seed)
+{
+    m_random = seed ? seed : 1;
+    m_next_id = 1000; // clear of the IDs the sim uses for the user aircraft
+    m_ownship = TrafficSample();
+    m_ownship.latitudeDeg = 47.4582;
+    m_ownship.longitudeDeg = 8.5555;
+    m_ownship.altitudeFt = 10000.0;
+    m_ownship.groundSpeedKt = 250.0;
+
+    m_ids.assign(static_cast<std::size_t>(count < 0 ? 0 : count), 0);
+    m_targets.assign(m_ids.size(), TrafficSample());
+    for (std::size_t i = 0; i < m_ids.size(); ++i) {
+        spawn(i, 0.0);
+    }
+}
+
+double SyntheticTrafficModel::random(double low, double high)
+{
+    // xorshift32, mapped to [low, high)
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return low + (high - low) * (m_random / 4294967296.0);
+}
+
+void SyntheticTrafficModel::spawn(std::size_t index, double minDistanceNm)
+{
+    // Uniform over the ring between minDistanceNm and the radius
+    const double bearing = random(0.0, 2.0 * M_PI);
+    const double inner = minDistanceNm / RadiusNm;
+    const double distance = RadiusNm * std::sqrt(random(inner * inner, 1.0));
+
+    TrafficSample &target = m_targets[index];
+    target.latitudeDeg = m_ownship.latitudeDeg + distance * std::cos(bearing) / 60.0;
+    target.longitudeDeg = m_ownship.longitudeDeg + distance * std::sin(bearing) / (60.0 * std::cos(m_ownship.latitudeDeg * M_PI / 180.0));
+    target.altitudeFt = m_ownship.altitudeFt + random(-6000.0, 6000.0);
+    target.groundSpeedKt = random(120.0, 450.0);
+    target.trackDeg = random(0.0, 360.0);
+    target.verticalSpeedFpm = random(0.0, 1.0) < 0.6 ? 0.0 : random(-1500.0, 1500.0);
+    m_ids[index] = m_next_id++;
+}
+
+void SyntheticTrafficModel::step(double dt, double ownshipTrackDeg, TrafficBatch &batch)
+{
+    m_ownship.trackDeg = ownshipTrackDeg;
+    advance(m_ownship, dt);
+
+    for (std::size_t i = 0; i < m_targets.size(); ++i) {
+        TrafficSample &target = m_targets[i];
+        advance(target, dt);
+        // Level off well away from the own ship's altitude band
+        if (std::fabs(target.altitudeFt - m_ownship.altitudeFt) > 8000.0) {
+            target.verticalSpeedFpm = target.altitudeFt > m_ownship.altitudeFt ? -std::fabs(target.verticalSpeedFpm) : std::fabs(target.verticalSpeedFpm);
+        }
+        if (distanceNm(m_ownship, target) > RadiusNm) {
+            // Replacements appear at the edge, as real traffic would
+            spawn(i, RadiusNm * 0.9);
+        }
+    }
+
+    batch.hasOwnship = true;
+    batch.ownship = m_ownship;
+    batch.objectIds = m_ids;
+    batch.samples = m_targets;
+    batch.completeSweep = true;
+}
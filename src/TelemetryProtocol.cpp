@@ -0,0 +1,261 @@
+#include "TelemetryProtocol.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace TelemetryProtocol {
+
+// --- Little endian helpers -----------------------------------------------------
+
+template <typename T>
+static void put(std::vector<std::uint8_t> &out, T value)
+{
+    // The dashboard only targets little-endian hosts (x86-64, ARM64)
+    std::uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool get(const std::uint8_t *data, std::size_t size, std::size_t &offset, T &value)
+{
+    if (offset + sizeof(T) > size) {
+        return false;
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+static void putVarint(std::vector<std::uint8_t> &out, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+static bool getVarint(const std::uint8_t *data, std::size_t size, std::size_t &offset, std::uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < size; shift += 7) {
+        std::uint8_t byte = data[offset++];
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Appends the message header; the length is patched by endMessage().
+static std::size_t beginMessage(std::vector<std::uint8_t> &out, MessageType type)
+{
+    std::size_t start = out.size();
+    put<std::uint16_t>(out, 0);
+    put(out, static_cast<std::uint8_t>(type));
+    return start;
+}
+
+static void endMessage(std::vector<std::uint8_t> &out, std::size_t start)
+{
+    std::uint16_t length = static_cast<std::uint16_t>(out.size() - start - sizeof(std::uint16_t));
+    std::memcpy(out.data() + start, &length, sizeof(length));
+}
+
+// --- Schema -------------------------------------------------------------------
+
+std::uint32_t schemaHash()
+{
+    // FNV-1a
+    std::uint32_t hash = 2166136261u;
+    auto mix = [&hash](const char *text) {
+        for (; *text; ++text) {
+            hash = (hash ^ static_cast<std::uint8_t>(*text)) * 16777619u;
+        }
+        hash = (hash ^ 0xFF) * 16777619u;
+    };
+    for (const AircraftSchema::Field &field : AircraftSchema::Fields) {
+        mix(field.name);
+        mix(field.unit);
+    }
+    return hash;
+}
+
+static double resolution(std::size_t index)
+{
+    const AircraftSchema::Field &field = AircraftSchema::Fields[index];
+    return field.isInteger || field.epsilon <= 0.0f ? 1.0 : field.epsilon;
+}
+
+void quantize(const AircraftData &data, State &state)
+{
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        state[i] = std::llround(AircraftSchema::value(data, i) / resolution(i));
+    }
+}
+
+void dequantize(const State &state, AircraftData &data)
+{
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        AircraftSchema::setValue(data, i, state[i] * resolution(i));
+    }
+}
+
+// --- Writers ------------------------------------------------------------------
+
+void writeHello(const Hello &hello, std::vector<std::uint8_t> &out)
+{
+    std::size_t start = beginMessage(out, MessageType::Hello);
+    put(out, Magic);
+    put(out, hello.version);
+    put(out, hello.rateHz);
+    endMessage(out, start);
+}
+
+void writeSetRate(std::uint16_t rateHz, std::vector<std::uint8_t> &out)
+{
+    std::size_t start = beginMessage(out, MessageType::SetRate);
+    put(out, rateHz);
+    endMessage(out, start);
+}
+
+void writeAck(std::uint32_t sequence, std::vector<std::uint8_t> &out)
+{
+    std::size_t start = beginMessage(out, MessageType::Ack);
+    put(out, sequence);
+    endMessage(out, start);
+}
+
+void writeWelcome(const Welcome &welcome, std::vector<std::uint8_t> &out)
+{
+    std::size_t start = beginMessage(out, MessageType::Welcome);
+    put(out, welcome.version);
+    put(out, welcome.fieldCount);
+    put(out, welcome.schemaHash);
+    endMessage(out, start);
+}
+
+void writeFrame(const FrameHeader &header, const State &base, const State &state, std::vector<std::uint8_t> &out)
+{
+    std::size_t start = beginMessage(out, MessageType::Frame);
+    put(out, header.sequence);
+    put(out, header.baseSequence);
+    put(out, header.sourceNs);
+    put(out, header.sentNs);
+    put(out, header.dropped);
+
+    std::uint64_t changed = 0;
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        if (state[i] != base[i]) {
+            changed |= std::uint64_t(1) << i;
+        }
+    }
+    put(out, changed);
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        if (changed & (std::uint64_t(1) << i)) {
+            putVarint(out, zigzag(state[i] - base[i]));
+        }
+    }
+    endMessage(out, start);
+}
+
+// --- Readers ------------------------------------------------------------------
+
+std::size_t nextMessage(const std::uint8_t *data, std::size_t size, Message &message)
+{
+    std::uint16_t length = 0;
+    std::size_t offset = 0;
+    if (!get(data, size, offset, length)) {
+        return 0;
+    }
+    if (length < 1 || length > MaxMessageSize) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    if (size < sizeof(length) + length) {
+        return 0;
+    }
+    message.type = static_cast<MessageType>(data[offset]);
+    message.payload = data + offset + 1;
+    message.size = length - 1u;
+    return sizeof(length) + length;
+}
+
+bool readHello(const Message &message, Hello &hello)
+{
+    std::size_t offset = 0;
+    std::uint32_t magic = 0;
+    return message.type == MessageType::Hello
+        && get(message.payload, message.size, offset, magic) && magic == Magic
+        && get(message.payload, message.size, offset, hello.version)
+        && get(message.payload, message.size, offset, hello.rateHz);
+}
+
+bool readSetRate(const Message &message, std::uint16_t &rateHz)
+{
+    std::size_t offset = 0;
+    return message.type == MessageType::SetRate && get(message.payload, message.size, offset, rateHz);
+}
+
+bool readAck(const Message &message, std::uint32_t &sequence)
+{
+    std::size_t offset = 0;
+    return message.type == MessageType::Ack && get(message.payload, message.size, offset, sequence);
+}
+
+bool readWelcome(const Message &message, Welcome &welcome)
+{
+    std::size_t offset = 0;
+    return message.type == MessageType::Welcome
+        && get(message.payload, message.size, offset, welcome.version)
+        && get(message.payload, message.size, offset, welcome.fieldCount)
+        && get(message.payload, message.size, offset, welcome.schemaHash);
+}
+
+static bool readFrameHeader(const Message &message, FrameHeader &header, std::size_t &offset)
+{
+    return message.type == MessageType::Frame
+        && get(message.payload, message.size, offset, header.sequence)
+        && get(message.payload, message.size, offset, header.baseSequence)
+        && get(message.payload, message.size, offset, header.sourceNs)
+        && get(message.payload, message.size, offset, header.sentNs)
+        && get(message.payload, message.size, offset, header.dropped);
+}
+
+bool readFrameHeader(const Message &message, FrameHeader &header)
+{
+    std::size_t offset = 0;
+    return readFrameHeader(message, header, offset);
+}
+
+bool readFrame(const Message &message, FrameHeader &header, State &state)
+{
+    std::size_t offset = 0;
+    std::uint64_t changed = 0;
+    if (!readFrameHeader(message, header, offset) || !get(message.payload, message.size, offset, changed)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        if (changed & (std::uint64_t(1) << i)) {
+            std::uint64_t delta = 0;
+            if (!getVarint(message.payload, message.size, offset, delta)) {
+                return false;
+            }
+            state[i] += unzigzag(delta);
+        }
+    }
+    return offset == message.size;
+}
+
+} // namespace TelemetryProtocol
@@ -0,0 +1,247 @@
+#include "TelemetryServer.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <loguru.hpp>
+#include "LatencyHistogram.h"
+#include "Metrics.h"
+#include "TelemetryProtocol.h"
+
+// Socket bytes a client may have queued before frames are dropped for it
+static constexpr qint64 max_pending_bytes = 16 * 1024;
+
+// Owns the listening socket and the clients; lives on the server thread.
+class TelemetryServerWorker : public QObject
+{
+public:
+    explicit TelemetryServerWorker(const SnapshotSlot<AircraftData> &latest)
+        : m_latest(latest)
+    {
+    }
+    ~TelemetryServerWorker() override;
+
+    bool listen(const QHostAddress &address, quint16 port);
+
+private:
+    struct Client {
+        QTcpSocket *socket = nullptr;
+        QTimer *timer = nullptr;
+        QByteArray received;
+        int rateHz = 0;
+        std::uint64_t sentVersion = 0;
+        std::uint32_t sequence = 0;
+        std::uint32_t dropped = 0; // since the last frame sent
+        // Newest acknowledged frame, the base of every delta
+        std::uint32_t ackedSequence = 0;
+        TelemetryProtocol::State ackedState {};
+        // Frames in flight, indexed by sequence % AckWindow
+        std::array<std::uint32_t, TelemetryProtocol::AckWindow> sentSequences {};
+        std::array<TelemetryProtocol::State, TelemetryProtocol::AckWindow> sentStates {};
+    };
+
+    void onNewConnection();
+    void onReadyRead(Client *client);
+    void setRate(Client *client, int rateHz);
+    void sendFrame(Client *client);
+    void removeClient(Client *client);
+    void write(Client *client, const std::vector<std::uint8_t> &bytes);
+
+    const SnapshotSlot<AircraftData> &m_latest;
+    QTcpServer *m_server = nullptr;
+    std::vector<std::unique_ptr<Client>> m_clients;
+    std::vector<std::uint8_t> m_buffer;
+};
+
+TelemetryServerWorker::~TelemetryServerWorker()
+{
+    Metrics::instance().telemetryClients.fetch_sub(m_clients.size(), std::memory_order_relaxed);
+}
+
+bool TelemetryServerWorker::listen(const QHostAddress &address, quint16 port)
+{
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, [this]() { onNewConnection(); });
+    if (!m_server->listen(address, port)) {
+        LOG_F(ERROR, "Telemetry server cannot listen on %s:%u: %s",
+              qPrintable(address.toString()), port, qPrintable(m_server->errorString()));
+        return false;
+    }
+    LOG_F(INFO, "Serving telemetry on %s:%u", qPrintable(address.toString()), m_server->serverPort());
+    return true;
+}
+
+void TelemetryServerWorker::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        auto client = std::make_unique<Client>();
+        Client *raw = client.get();
+        raw->socket = socket;
+        raw->timer = new QTimer(this);
+        raw->timer->setTimerType(Qt::PreciseTimer);
+        // Small frames must leave immediately instead of waiting for Nagle
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(raw->timer, &QTimer::timeout, this, [this, raw]() { sendFrame(raw); });
+        connect(socket, &QTcpSocket::readyRead, this, [this, raw]() { onReadyRead(raw); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, raw]() { removeClient(raw); });
+        m_clients.push_back(std::move(client));
+        Metrics::instance().telemetryClients.fetch_add(1, std::memory_order_relaxed);
+        LOG_F(INFO, "Telemetry client connected from %s", qPrintable(socket->peerAddress().toString()));
+    }
+}
+
+void TelemetryServerWorker::onReadyRead(Client *client)
+{
+    using namespace TelemetryProtocol;
+
+    client->received += client->socket->readAll();
+    const auto *data = reinterpret_cast<const std::uint8_t *>(client->received.constData());
+    const std::size_t size = static_cast<std::size_t>(client->received.size());
+    std::size_t offset = 0;
+    Message message;
+    while (std::size_t length = nextMessage(data + offset, size - offset, message)) {
+        if (length == SIZE_MAX) {
+            LOG_F(WARNING, "Telemetry client sent a corrupt stream, closing");
+            client->socket->abort();
+            return;
+        }
+        offset += length;
+
+        Hello hello;
+        std::uint16_t rateHz = 0;
+        std::uint32_t sequence = 0;
+        if (readHello(message, hello)) {
+            if (hello.version != Version) {
+                LOG_F(WARNING, "Telemetry client speaks protocol %u, expected %u", hello.version, Version);
+                client->socket->abort();
+                return;
+            }
+            m_buffer.clear();
+            writeWelcome({ Version, static_cast<std::uint16_t>(AircraftSchema::FieldCount), schemaHash() }, m_buffer);
+            write(client, m_buffer);
+            setRate(client, hello.rateHz);
+        } else if (readSetRate(message, rateHz)) {
+            setRate(client, rateHz);
+        } else if (readAck(message, sequence)) {
+            // Acks may arrive out of order; only newer frames become the base
+            const std::uint32_t slot = sequence % AckWindow;
+            if (sequence > client->ackedSequence && client->sentSequences[slot] == sequence) {
+                client->ackedSequence = sequence;
+                client->ackedState = client->sentStates[slot];
+            }
+        }
+    }
+    client->received.remove(0, static_cast<qsizetype>(offset));
+}
+
+void TelemetryServerWorker::setRate(Client *client, int rateHz)
+{
+    client->rateHz = qBound(1, rateHz, TelemetryServer::MaxRateHz);
+    client->timer->start(qMax(1, 1000 / client->rateHz));
+}
+
+void TelemetryServerWorker::sendFrame(Client *client)
+{
+    using namespace TelemetryProtocol;
+
+    if (m_latest.version() == client->sentVersion) {
+        return; // nothing new since the last frame
+    }
+    Metrics &metrics = Metrics::instance();
+    if (client->socket->bytesToWrite() > max_pending_bytes || client->sequence - client->ackedSequence >= AckWindow) {
+        // Slow reader: skip this frame, the next one carries all changes
+        // and tells the client how many were skipped
+        ++client->dropped;
+        metrics.telemetryFramesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    AircraftData data;
+    if (!m_latest.load(data, client->sentVersion)) {
+        return;
+    }
+    const std::uint32_t sequence = ++client->sequence;
+    const std::uint32_t slot = sequence % AckWindow;
+    client->sentSequences[slot] = sequence;
+    quantize(data, client->sentStates[slot]);
+
+    FrameHeader header;
+    header.sequence = sequence;
+    header.baseSequence = client->ackedSequence;
+    header.sourceNs = data.received_ns;
+    header.sentNs = LatencyHistogram::now();
+    header.dropped = client->dropped;
+    client->dropped = 0;
+    m_buffer.clear();
+    writeFrame(header, client->ackedState, client->sentStates[slot], m_buffer);
+    write(client, m_buffer);
+    metrics.telemetryFramesSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TelemetryServerWorker::write(Client *client, const std::vector<std::uint8_t> &bytes)
+{
+    client->socket->write(reinterpret_cast<const char *>(bytes.data()), static_cast<qint64>(bytes.size()));
+    Metrics::instance().telemetryBytesSent.fetch_add(bytes.size(), std::memory_order_relaxed);
+}
+
+void TelemetryServerWorker::removeClient(Client *client)
+{
+    LOG_F(INFO, "Telemetry client disconnected after %u frames", client->sequence);
+    // Both capture the client, which is freed below. The timer goes now so
+    // a timeout already due in this event loop pass cannot fire; the socket
+    // is emitting the signal that got us here and only loses its connections.
+    delete client->timer;
+    client->socket->disconnect(this);
+    client->socket->deleteLater();
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it->get() == client) {
+            m_clients.erase(it);
+            Metrics::instance().telemetryClients.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+TelemetryServer::TelemetryServer(QObject *parent)
+    : QObject(parent)
+{
+    m_thread.setObjectName("TelemetryServer");
+}
+
+TelemetryServer::~TelemetryServer()
+{
+    close();
+}
+
+bool TelemetryServer::listen(const QHostAddress &address, quint16 port)
+{
+    close();
+    m_worker = new TelemetryServerWorker(m_latest);
+    m_worker->moveToThread(&m_thread);
+    m_thread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(m_worker, [&]() { listening = m_worker->listen(address, port); },
+                              Qt::BlockingQueuedConnection);
+    if (!listening) {
+        close();
+    } else if (!address.isLoopback()) {
+        LOG_F(WARNING, "Telemetry server is reachable from other hosts");
+    }
+    return listening;
+}
+
+void TelemetryServer::close()
+{
+    if (!m_worker) {
+        return;
+    }
+    // Sockets must be destroyed on the thread that owns them
+    TelemetryServerWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker]() { delete worker; }, Qt::BlockingQueuedConnection);
+    m_worker = nullptr;
+    m_thread.quit();
+    m_thread.wait();
+}
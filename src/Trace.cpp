@@ -0,0 +1,136 @@
+#include "Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <loguru.hpp>
+
+namespace Trace {
+
+namespace {
+
+struct Event {
+    const char *name;
+    std::int64_t start;
+    std::int64_t end;
+};
+
+constexpr std::size_t RingCapacity = 1 << 16;
+
+// Written only by its thread; the dump reads the events below head.
+struct ThreadBuffer {
+    int tid = 0;
+    char threadName[32] = {};
+    std::atomic<std::uint64_t> head { 0 };
+    std::unique_ptr<Event[]> events { new Event[RingCapacity] };
+};
+
+// Buffers outlive their threads so spans of finished threads can still be dumped
+std::mutex g_buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+ThreadBuffer &threadBuffer()
+{
+    thread_local ThreadBuffer *buffer = [] {
+        auto created = std::make_unique<ThreadBuffer>();
+        loguru::get_thread_name(created->threadName, sizeof(created->threadName), false);
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        created->tid = static_cast<int>(g_buffers.size()) + 1;
+        g_buffers.push_back(std::move(created));
+        return g_buffers.back().get();
+    }();
+    return *buffer;
+}
+
+void writeJsonString(std::FILE *file, const char *text)
+{
+    std::fputc('"', file);
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) >= 0x20) {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+void setEnabled(bool enabled)
+{
+    if (enabled) {
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        for (auto &buffer : g_buffers) {
+            buffer->head.store(0, std::memory_order_relaxed);
+        }
+    }
+    g_enabled.store(enabled, std::memory_order_relaxed);
+    LOG_F(INFO, "Tracing %s", enabled ? "enabled" : "disabled");
+}
+
+void record(const char *name, std::int64_t startNs, std::int64_t endNs)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % RingCapacity] = { name, startNs, endNs };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+bool dumpChromeJson(const std::string &path)
+{
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_F(ERROR, "Failed to open trace file %s", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+
+    // Timestamps are relative to the earliest retained event
+    std::int64_t origin = INT64_MAX;
+    for (const auto &buffer : g_buffers) {
+        std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        std::uint64_t first = head > RingCapacity ? head - RingCapacity : 0;
+        for (std::uint64_t i = first; i < head; ++i) {
+            origin = std::min(origin, buffer->events[i % RingCapacity].start);
+        }
+    }
+
+    std::size_t written = 0;
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    for (const auto &buffer : g_buffers) {
+        if (written) {
+            std::fputs(",\n", file);
+        }
+        std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buffer->tid);
+        writeJsonString(file, buffer->threadName);
+        std::fputs("}}", file);
+        ++written;
+
+        std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        std::uint64_t first = head > RingCapacity ? head - RingCapacity : 0;
+        for (std::uint64_t i = first; i < head; ++i) {
+            const Event &event = buffer->events[i % RingCapacity];
+            std::fputs(",\n{\"name\":", file);
+            writeJsonString(file, event.name);
+            std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         buffer->tid, (event.start - origin) / 1e3, (event.end - event.start) / 1e3);
+            ++written;
+        }
+    }
+    std::fputs("\n]}\n", file);
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (ok) {
+        LOG_F(INFO, "Wrote %zu trace events to %s", written, path.c_str());
+    } else {
+        LOG_F(ERROR, "Failed to write trace file %s", path.c_str());
+    }
+    return ok;
+}
+
+} // namespace Trace
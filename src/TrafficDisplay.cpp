@@ -0,0 +1,176 @@
+#include "TrafficDisplay.h"
+#include <QPainter>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Logical radius of the outer range ring
+static constexpr qreal display_radius = 88.0;
+
+// Advisory levels, loosely following TCAS: time to closest approach and
+// vertical separation decide how loud a contact is drawn.
+enum class Threat { Other, Proximate, Advisory, Resolution };
+
+static Threat threatLevel(const TrafficStore::Contact &contact)
+{
+    const float separationFt = std::fabs(contact.relativeAltitudeFt);
+    const float closingSeconds = contact.closureKt > 0.0f ? contact.distanceNm / contact.closureKt * 3600.0f : INFINITY;
+    if (closingSeconds < 25.0f && separationFt < 600.0f) {
+        return Threat::Resolution;
+    }
+    if (closingSeconds < 40.0f && separationFt < 850.0f) {
+        return Threat::Advisory;
+    }
+    if (contact.distanceNm < 6.0f && separationFt < 1200.0f) {
+        return Threat::Proximate;
+    }
+    return Threat::Other;
+}
+
+static QColor threatColor(Threat threat)
+{
+    switch (threat) {
+        case Threat::Resolution: return QColor(255, 40, 40);
+        case Threat::Advisory: return QColor(255, 190, 0);
+        default: return QColor(0, 220, 255);
+    }
+}
+
+TrafficDisplay::TrafficDisplay(QWidget *parent)
+    : InstrumentWidget(200.0, parent)
+    , m_altitude_readout(QFont("Arial", 7, QFont::Bold), Qt::white)
+{
+    setMinimumSize(200, 200);
+    m_contacts.reserve(MaxContacts);
+    m_render_contacts.reserve(MaxContacts);
+}
+
+void TrafficDisplay::setRange(float rangeNm)
+{
+    m_range_nm = qMax(1.0f, rangeNm);
+    invalidateStaticLayers(); // range labels
+    updateInstrument();
+}
+
+void TrafficDisplay::setTraffic(const std::vector<TrafficStore::Contact> &contacts, float ownshipTrackDeg)
+{
+    if (contacts.empty() && m_contacts.empty()) {
+        // Nothing drawn depends on the track without traffic
+        m_track_degrees = ownshipTrackDeg;
+        countSuppressedRepaint();
+        return;
+    }
+    const std::size_t count = qMin(contacts.size(), static_cast<std::size_t>(MaxContacts));
+    m_contacts.assign(contacts.begin(), contacts.begin() + count);
+    m_track_degrees = ownshipTrackDeg;
+    updateInstrument();
+}
+
+void TrafficDisplay::clearTraffic()
+{
+    setTraffic({}, m_track_degrees);
+}
+
+void TrafficDisplay::captureRenderState()
+{
+    m_render_range_nm = m_range_nm;
+    m_render_track_degrees = m_track_degrees;
+    m_render_contacts = m_contacts;
+}
+
+void TrafficDisplay::staticLayersRebuilt()
+{
+    m_altitude_readout.rebuild(deviceScale());
+}
+
+void TrafficDisplay::drawStaticBackground(QPainter &painter)
+{
+    painter.setPen(QPen(Qt::white, 2));
+    painter.setBrush(Qt::black);
+    painter.drawEllipse(QPointF(0, 0), 98, 98);
+
+    // Range rings at half and full range
+    painter.setBrush(Qt::NoBrush);
+    painter.setPen(QPen(QColor(120, 120, 120), 1, Qt::DashLine));
+    painter.drawEllipse(QPointF(0, 0), display_radius / 2, display_radius / 2);
+    painter.setPen(QPen(QColor(120, 120, 120), 1));
+    painter.drawEllipse(QPointF(0, 0), display_radius, display_radius);
+
+    QFont font("Arial", 6);
+    painter.setFont(font);
+    painter.setPen(QColor(160, 160, 160));
+    painter.drawText(QRectF(4, -display_radius / 2 - 10, 30, 10), Qt::AlignLeft | Qt::AlignVCenter,
+                     QString::number(m_render_range_nm / 2, 'g', 3));
+    painter.drawText(QRectF(4, -display_radius - 1, 30, 10), Qt::AlignLeft | Qt::AlignVCenter,
+                     QString("%1 NM").arg(m_render_range_nm, 0, 'g', 3));
+
+    // Own ship, nose up
+    painter.setPen(QPen(Qt::white, 1.5));
+    painter.setBrush(Qt::NoBrush);
+    QPolygonF ownship;
+    ownship << QPointF(0, -7) << QPointF(5, 6) << QPointF(0, 3) << QPointF(-5, 6);
+    painter.drawPolygon(ownship);
+
+    painter.setPen(QPen(Qt::white, 1));
+    painter.drawText(QRectF(-30, 80, 60, 12), Qt::AlignCenter, "TFC");
+}
+
+void TrafficDisplay::drawDynamicLayer(QPainter &painter)
+{
+    // Farthest first, so the closest contacts end up on top
+    for (auto it = m_render_contacts.rbegin(); it != m_render_contacts.rend(); ++it) {
+        if (it->distanceNm <= m_render_range_nm) {
+            drawContact(painter, *it);
+        }
+    }
+}
+
+void TrafficDisplay::drawContact(QPainter &painter, const TrafficStore::Contact &contact) const
+{
+    const qreal relativeBearing = (contact.bearingDeg - m_render_track_degrees) * M_PI / 180.0;
+    const qreal radius = contact.distanceNm / m_render_range_nm * display_radius;
+    const QPointF position(radius * std::sin(relativeBearing), -radius * std::cos(relativeBearing));
+
+    const Threat threat = threatLevel(contact);
+    const QColor color = threatColor(threat);
+    painter.setPen(QPen(color, 1.2));
+    painter.setBrush(threat == Threat::Other ? QBrush(Qt::NoBrush) : QBrush(color));
+
+    const qreal size = 4.0;
+    switch (threat) {
+        case Threat::Resolution:
+            painter.drawRect(QRectF(position.x() - size, position.y() - size, 2 * size, 2 * size));
+            break;
+        case Threat::Advisory:
+            painter.drawEllipse(position, size, size);
+            break;
+        default: {
+            QPointF diamond[4] = { position + QPointF(0, -size), position + QPointF(size, 0),
+                                   position + QPointF(0, size), position + QPointF(-size, 0) };
+            painter.drawPolygon(diamond, 4);
+            break;
+        }
+    }
+
+    // Relative altitude in hundreds of feet, above the symbol when the
+    // contact is higher and below it otherwise
+    const bool above = contact.relativeAltitudeFt >= 0.0f;
+    char altitudeText[8];
+    altitudeText[0] = above ? '+' : '-';
+    int length = 1 + ReadoutRenderer::formatFixed(altitudeText + 1, sizeof(altitudeText) - 1,
+                                                  std::fabs(contact.relativeAltitudeFt) / 100.0, 0, 2);
+    QRectF tagRect(position.x() - 15, above ? position.y() - size - 10 : position.y() + size, 30, 10);
+    m_altitude_readout.draw(painter, tagRect, Qt::AlignCenter, altitudeText, length);
+
+    // Climb or descent trend arrow beside the symbol
+    if (std::fabs(contact.verticalSpeedFpm) >= 500.0f) {
+        const qreal direction = contact.verticalSpeedFpm > 0.0f ? -1.0 : 1.0;
+        const QPointF base = position + QPointF(size + 4, -direction * 4);
+        const QPointF tip = position + QPointF(size + 4, direction * 4);
+        painter.drawLine(base, tip);
+        painter.drawLine(tip, tip + QPointF(-2, -direction * 2));
+        painter.drawLine(tip, tip + QPointF(2, -direction * 2));
+    }
+}
@@ -0,0 +1,301 @@
+#include "TrafficStore.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Own ship distance from the anchor that triggers re-anchoring
+static constexpr float reanchor_distance_nm = 60.0f;
+
+void TrafficStore::anchorAt(double latitudeDeg, double longitudeDeg)
+{
+    m_anchored = true;
+    m_anchor_latitude = latitudeDeg;
+    m_anchor_longitude = longitudeDeg;
+    m_anchor_cos = std::cos(latitudeDeg * M_PI / 180.0);
+
+    m_cells.clear();
+    for (std::uint32_t i = 0; i < m_ids.size(); ++i) {
+        TrafficSample sample;
+        sample.latitudeDeg = m_latitude[i];
+        sample.longitudeDeg = m_longitude[i];
+        project(sample, m_x[i], m_y[i]);
+        addToCell(i);
+    }
+}
+
+void TrafficStore::project(const TrafficSample &sample, float &x, float &y) const
+{
+    double dLon = std::remainder(sample.longitudeDeg - m_anchor_longitude, 360.0);
+    x = static_cast<float>(dLon * 60.0 * m_anchor_cos);
+    y = static_cast<float>((sample.latitudeDeg - m_anchor_latitude) * 60.0);
+}
+
+void TrafficStore::velocity(const TrafficSample &sample, float &vx, float &vy)
+{
+    double track = sample.trackDeg * M_PI / 180.0;
+    vx = static_cast<float>(sample.groundSpeedKt * std::sin(track));
+    vy = static_cast<float>(sample.groundSpeedKt * std::cos(track));
+}
+
+std::uint64_t TrafficStore::cellKey(int cx, int cy)
+{
+    // Shift the two's complement bits; shifting a negative int64 is undefined
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+}
+
+int TrafficStore::cellCoordinate(float value)
+{
+    return static_cast<int>(std::floor(value / CellSizeNm));
+}
+
+void TrafficStore::addToCell(std::uint32_t index)
+{
+    m_cell[index] = cellKey(cellCoordinate(m_x[index]), cellCoordinate(m_y[index]));
+    m_cells[m_cell[index]].push_back(index);
+}
+
+void TrafficStore::removeFromCell(std::uint32_t index)
+{
+    auto it = m_cells.find(m_cell[index]);
+    if (it == m_cells.end()) {
+        return;
+    }
+    std::vector<std::uint32_t> &members = it->second;
+    members.erase(std::find(members.begin(), members.end(), index));
+    if (members.empty()) {
+        m_cells.erase(it);
+    }
+}
+
+void TrafficStore::setOwnship(const TrafficSample &sample)
+{
+    if (!m_anchored) {
+        anchorAt(sample.latitudeDeg, sample.longitudeDeg);
+    }
+    project(sample, m_own_x, m_own_y);
+    if (std::hypot(m_own_x, m_own_y) > reanchor_distance_nm) {
+        anchorAt(sample.latitudeDeg, sample.longitudeDeg);
+        project(sample, m_own_x, m_own_y);
+    }
+    velocity(sample, m_own_vx, m_own_vy);
+    m_own_altitude = static_cast<float>(sample.altitudeFt);
+    m_own_track = static_cast<float>(sample.trackDeg);
+    m_has_ownship = true;
+}
+
+void TrafficStore::upsert(std::uint32_t objectId, const TrafficSample &sample, std::int64_t timeNs)
+{
+    if (!m_anchored) {
+        anchorAt(sample.latitudeDeg, sample.longitudeDeg);
+    }
+
+    auto found = m_index.find(objectId);
+    std::uint32_t index;
+    bool inserted = found == m_index.end();
+    if (inserted) {
+        index = static_cast<std::uint32_t>(m_ids.size());
+        m_index.emplace(objectId, index);
+        m_ids.push_back(objectId);
+        m_latitude.push_back(0.0);
+        m_longitude.push_back(0.0);
+        m_x.push_back(0.0f);
+        m_y.push_back(0.0f);
+        m_altitude.push_back(0.0f);
+        m_vx.push_back(0.0f);
+        m_vy.push_back(0.0f);
+        m_vertical_speed.push_back(0.0f);
+        m_updated_ns.push_back(0);
+        m_cell.push_back(0);
+    } else {
+        index = found->second;
+    }
+
+    m_latitude[index] = sample.latitudeDeg;
+    m_longitude[index] = sample.longitudeDeg;
+    project(sample, m_x[index], m_y[index]);
+    m_altitude[index] = static_cast<float>(sample.altitudeFt);
+    velocity(sample, m_vx[index], m_vy[index]);
+    m_vertical_speed[index] = static_cast<float>(sample.verticalSpeedFpm);
+    m_updated_ns[index] = timeNs;
+
+    const std::uint64_t cell = cellKey(cellCoordinate(m_x[index]), cellCoordinate(m_y[index]));
+    if (inserted) {
+        addToCell(index);
+    } else if (cell != m_cell[index]) {
+        removeFromCell(index);
+        addToCell(index);
+    }
+}
+
+bool TrafficStore::remove(std::uint32_t objectId)
+{
+    auto found = m_index.find(objectId);
+    if (found == m_index.end()) {
+        return false;
+    }
+    const std::uint32_t index = found->second;
+    const std::uint32_t last = static_cast<std::uint32_t>(m_ids.size() - 1);
+    removeFromCell(index);
+    m_index.erase(found);
+
+    if (index != last) {
+        // Move the last object into the freed slot
+        std::vector<std::uint32_t> &members = m_cells[m_cell[last]];
+        *std::find(members.begin(), members.end(), last) = index;
+        m_index[m_ids[last]] = index;
+
+        m_ids[index] = m_ids[last];
+        m_latitude[index] = m_latitude[last];
+        m_longitude[index] = m_longitude[last];
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_altitude[index] = m_altitude[last];
+        m_vx[index] = m_vx[last];
+        m_vy[index] = m_vy[last];
+        m_vertical_speed[index] = m_vertical_speed[last];
+        m_updated_ns[index] = m_updated_ns[last];
+        m_cell[index] = m_cell[last];
+    }
+
+    m_ids.pop_back();
+    m_latitude.pop_back();
+    m_longitude.pop_back();
+    m_x.pop_back();
+    m_y.pop_back();
+    m_altitude.pop_back();
+    m_vx.pop_back();
+    m_vy.pop_back();
+    m_vertical_speed.pop_back();
+    m_updated_ns.pop_back();
+    m_cell.pop_back();
+    return true;
+}
+
+std::size_t TrafficStore::evictOlderThan(std::int64_t timeNs)
+{
+    std::size_t evicted = 0;
+    // Backwards, so the objects swapped into freed slots were already checked
+    for (std::size_t i = m_ids.size(); i-- > 0;) {
+        if (m_updated_ns[i] < timeNs) {
+            remove(m_ids[i]);
+            ++evicted;
+        }
+    }
+    return evicted;
+}
+
+void TrafficStore::apply(const TrafficBatch &batch)
+{
+    if (batch.hasOwnship) {
+        setOwnship(batch.ownship);
+    }
+    for (std::size_t i = 0; i < batch.objectIds.size(); ++i) {
+        upsert(batch.objectIds[i], batch.samples[i], batch.timeNs);
+    }
+    if (batch.completeSweep) {
+        evictOlderThan(batch.timeNs);
+    }
+}
+
+void TrafficStore::clear()
+{
+    *this = TrafficStore();
+}
+
+TrafficStore::Contact TrafficStore::makeContact(std::uint32_t index) const
+{
+    const float dx = m_x[index] - m_own_x;
+    const float dy = m_y[index] - m_own_y;
+    const float distance = std::hypot(dx, dy);
+    const float rvx = m_vx[index] - m_own_vx;
+    const float rvy = m_vy[index] - m_own_vy;
+
+    Contact contact;
+    contact.objectId = m_ids[index];
+    contact.distanceNm = distance;
+    float bearing = std::atan2(dx, dy) * static_cast<float>(180.0 / M_PI);
+    contact.bearingDeg = bearing < 0.0f ? bearing + 360.0f : bearing;
+    contact.relativeAltitudeFt = m_altitude[index] - m_own_altitude;
+    contact.closureKt = distance > 0.0f ? -(dx * rvx + dy * rvy) / distance : 0.0f;
+    contact.verticalSpeedFpm = m_vertical_speed[index];
+    return contact;
+}
+
+bool TrafficStore::contact(std::uint32_t objectId, Contact &result) const
+{
+    auto found = m_index.find(objectId);
+    if (found == m_index.end()) {
+        return false;
+    }
+    result = makeContact(found->second);
+    return true;
+}
+
+void TrafficStore::nearest(std::size_t count, float rangeNm, std::vector<Contact> &contacts) const
+{
+    contacts.clear();
+    if (count == 0 || m_ids.empty() || !m_has_ownship) {
+        return;
+    }
+
+    // Max-heap of (squared distance, index) holding the best candidates so far
+    std::vector<std::pair<float, std::uint32_t>> heap;
+    heap.reserve(count + 1);
+    const float rangeSquared = rangeNm * rangeNm;
+    const int ownCx = cellCoordinate(m_own_x);
+    const int ownCy = cellCoordinate(m_own_y);
+    const int maxRing = static_cast<int>(std::ceil(rangeNm / CellSizeNm)) + 1;
+
+    auto visit = [&](int cx, int cy) {
+        auto cell = m_cells.find(cellKey(cx, cy));
+        if (cell == m_cells.end()) {
+            return;
+        }
+        for (std::uint32_t index : cell->second) {
+            const float dx = m_x[index] - m_own_x;
+            const float dy = m_y[index] - m_own_y;
+            const float distanceSquared = dx * dx + dy * dy;
+            if (distanceSquared > rangeSquared) {
+                continue;
+            }
+            if (heap.size() < count) {
+                heap.emplace_back(distanceSquared, index);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (distanceSquared < heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = { distanceSquared, index };
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    };
+
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        // Every cell of this ring is at least (ring - 1) cells away
+        const float closest = (ring - 1) * CellSizeNm;
+        if (ring > 1 && (closest > rangeNm || (heap.size() == count && closest * closest > heap.front().first))) {
+            break;
+        }
+        if (ring == 0) {
+            visit(ownCx, ownCy);
+            continue;
+        }
+        for (int d = -ring; d <= ring; ++d) {
+            visit(ownCx + d, ownCy - ring);
+            visit(ownCx + d, ownCy + ring);
+        }
+        for (int d = -ring + 1; d <= ring - 1; ++d) {
+            visit(ownCx - ring, ownCy + d);
+            visit(ownCx + ring, ownCy + d);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    contacts.reserve(heap.size());
+    for (const auto &candidate : heap) {
+        contacts.push_back(makeContact(candidate.second));
+    }
+}
@@ -1,7 +1,51 @@
-#include <QApplication>
+#include "DashboardApplication.h"
+#include <QCommandLineParser>
 #include "MainWindow.h"
+#include "FlightRecorder.h"
+#include "MetricsServer.h"
+#include "ReplaySource.h"
+#include "SharedMemoryBus.h"
+#include "SyntheticFlightSource.h"
+#include "TelemetryServer.h"
+#ifdef MSFS_DASHBOARD_WITH_SIMCONNECT
+#include "SimConnectClient.h"
+#endif
 #include <loguru.hpp>
 
+static TelemetrySource *createTelemetrySource(const QCommandLineParser &parser)
+{
+    if (parser.isSet("replay")) {
+        auto *replay = new ReplaySource();
+        if (!replay->open(parser.value("replay"))) {
+            delete replay;
+            return nullptr;
+        }
+        replay->setSpeed(parser.value("replay-speed").toDouble());
+        replay->setStartPosition(static_cast<qint64>(parser.value("replay-start").toDouble() * 1e6));
+        return replay;
+    }
+
+    bool synthetic = parser.isSet("synthetic");
+#ifndef MSFS_DASHBOARD_WITH_SIMCONNECT
+    synthetic = true;
+#endif
+
+    if (synthetic) {
+        double rate = parser.value("synthetic-rate").toDouble();
+        LOG_F(INFO, "Using synthetic telemetry source at %.1f Hz", rate);
+        auto *source = new SyntheticFlightSource(rate);
+        source->setTrafficCount(parser.value("synthetic-traffic").toInt());
+        return source;
+    }
+
+#ifdef MSFS_DASHBOARD_WITH_SIMCONNECT
+    LOG_F(INFO, "Using SimConnect telemetry source");
+    return new SimConnectClient();
+#else
+    return nullptr;
+#endif
+}
+
 int main(int argc, char *argv[])
 {
     // Initialize loguru
@@ -15,8 +59,81 @@ int main(int argc, char *argv[])
     
     LOG_F(INFO, "MSFS Dashboard starting...");
     
-    QApplication a(argc, argv);
-    MainWindow w;
+    DashboardApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "synthetic", "Use the synthetic flight generator instead of SimConnect." },
+        { "synthetic-rate", "Synthetic sample rate in Hz (1 to 20000).", "hz", "60" },
+        { "synthetic-traffic", "Number of synthetic AI aircraft around the own ship.", "count", "0" },
+        { "record", "Record received telemetry to a flight data file (.fdr).", "file" },
+        { "replay", "Play back a recorded flight data file instead of SimConnect.", "file" },
+        { "replay-speed", "Replay speed factor.", "factor", "1" },
+        { "replay-start", "Replay start position in seconds.", "seconds", "0" },
+        { "metrics-port", "Serve Prometheus metrics on this TCP port (0 disables).", "port", "0" },
+        { "metrics-bind", "Address the metrics endpoint listens on.", "address", "127.0.0.1" },
+        { "telemetry-port", "Serve live telemetry to subscribers on this TCP port (0 disables).", "port", "0" },
+        { "telemetry-bind", "Address the telemetry server listens on.", "address", "127.0.0.1" },
+        { "shm", "Publish telemetry to shared memory for other local processes." },
+        { "shm-name", "Name of the shared-memory region.", "name", MSFS_TELEMETRY_SHM_DEFAULT_NAME },
+        { "render-mode", "Instrument rendering: widgets, composite or threaded.", "mode", "widgets" },
+        { "alert-rules", "Load additional alert rules from this file.", "file" },
+        { "prediction-horizon", "Extrapolate instruments up to this far past the last sim frame (0 disables).", "ms", "100" },
+    });
+    parser.process(a);
+
+    InstrumentRenderMode renderMode = InstrumentRenderMode::Widgets;
+    const QString renderModeName = parser.value("render-mode");
+    if (renderModeName == "composite") {
+        renderMode = InstrumentRenderMode::Composite;
+    } else if (renderModeName == "threaded") {
+        renderMode = InstrumentRenderMode::Threaded;
+    } else if (renderModeName != "widgets") {
+        LOG_F(ERROR, "Unknown render mode %s", qPrintable(renderModeName));
+        return 1;
+    }
+
+    TelemetrySource *telemetrySource = createTelemetrySource(parser);
+    if (!telemetrySource) {
+        return 1;
+    }
+
+    // Declared before the window so it outlives the telemetry source. Fed on
+    // the producing thread so every sample is kept, see snapshotDecoded
+    FlightRecorder recorder;
+    if (parser.isSet("record") && recorder.start(parser.value("record"))) {
+        QObject::connect(telemetrySource, &TelemetrySource::snapshotDecoded,
+                         &recorder, &FlightRecorder::append, Qt::DirectConnection);
+    }
+
+    MetricsServer metricsServer;
+    if (quint16 metricsPort = parser.value("metrics-port").toUShort()) {
+        metricsServer.listen(QHostAddress(parser.value("metrics-bind")), metricsPort);
+    }
+
+    // Also declared before the window, so it outlives the telemetry source
+    TelemetryServer telemetryServer;
+    if (quint16 telemetryPort = parser.value("telemetry-port").toUShort()) {
+        if (telemetryServer.listen(QHostAddress(parser.value("telemetry-bind")), telemetryPort)) {
+            QObject::connect(telemetrySource, &TelemetrySource::aircraftDataUpdated,
+                             &telemetryServer, &TelemetryServer::publish);
+        }
+    }
+
+    // Written on the source's producing thread, see TelemetrySource::snapshotDecoded
+    SharedMemoryBus sharedMemoryBus;
+    if (parser.isSet("shm") && sharedMemoryBus.open(parser.value("shm-name"))) {
+        QObject::connect(telemetrySource, &TelemetrySource::snapshotDecoded,
+                         &sharedMemoryBus, &SharedMemoryBus::publish, Qt::DirectConnection);
+    }
+
+    MainWindow w(telemetrySource);
+    w.setRenderMode(renderMode);
+    if (parser.isSet("alert-rules") && !w.loadAlertRules(parser.value("alert-rules"))) {
+        return 1;
+    }
+    w.setPredictionHorizon(qMax(0, parser.value("prediction-horizon").toInt()) * 1000000LL);
     w.setWindowTitle("MSFS Dashboard");
     w.show();
     
@@ -26,4 +143,4 @@ int main(int argc, char *argv[])
     
     LOG_F(INFO, "MSFS Dashboard shutting down with exit code: %d", result);
     return result;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,196 @@
+// Compiles alert rules and drives them through AlertEngine::evaluate to
+// check parse errors, expression results and the debounce and hysteresis
+// timers.
+
+#include "AlertEngine.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr std::uint64_t AllFields = ~std::uint64_t(0);
+constexpr std::int64_t Second = 1000000000;
+
+bool check(bool condition, const char *message)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message);
+    }
+    return condition;
+}
+
+AircraftData makeData(float altitude, float n1)
+{
+    AircraftData data {};
+    data.plane_alt_above_ground = altitude;
+    data.eng_n1_1 = n1;
+    data.gear_handle_position = 1;
+    return data;
+}
+
+bool compiles(const std::string &text)
+{
+    AlertEngine engine;
+    return engine.compile(text, "test");
+}
+
+// Result of a condition evaluated once against data. Rules only run when a
+// field they read changed, so the probe reads one besides the condition.
+bool holds(const std::string &condition, const AircraftData &data = makeData(800.0f, 42.0f))
+{
+    AlertEngine engine;
+    if (!engine.compile("probe when gear_handle_position == 1 and (" + condition + ")", "test")) {
+        std::fprintf(stderr, "FAIL: cannot compile %s\n", condition.c_str());
+        return false;
+    }
+    engine.evaluate(data, AllFields, 1);
+    return engine.isActive(0);
+}
+
+std::string nested(int operands)
+{
+    // Right-nested sums keep every operand on the stack until the end
+    std::string expression = "1";
+    for (int i = 1; i < operands; ++i) {
+        expression = "1 + (" + expression + ")";
+    }
+    return expression + " > 0";
+}
+
+bool testCompileErrors()
+{
+    AlertEngine engine;
+    const bool first = engine.compile("low \"LOW\" priority 2 when plane_alt_above_ground < 500 for 1.5s clear when plane_alt_above_ground > 600 for 250ms\n"
+                                      "# comment\n\n"
+                                      "spool when 'turb eng n1:1' > 90 for 1 min\r\n",
+                                      "test");
+    const bool bad = !engine.compile("ok when 1 > 0\nbroken when 1 >", "test");
+    const AlertEngine::Rule &low = engine.rule(0);
+
+    return check(first && engine.ruleCount() == 2, "valid rules must compile")
+        && check(low.message == "LOW" && low.priority == 2, "message and priority must be parsed")
+        && check(low.setDelayNs == Second * 3 / 2 && low.clearDelayNs == Second / 4, "durations must be parsed")
+        && check(engine.rule(1).setDelayNs == 60 * Second, "minute durations must be parsed")
+        && check(bad && engine.ruleCount() == 2 && engine.find("ok") < 0, "a failing source must add nothing")
+        && check(!compiles("when 1 > 0"), "a keyword is not a rule name")
+        && check(!compiles("r 1 > 0"), "'when' is required")
+        && check(!compiles("r when unknown_field > 0"), "unknown fields must be rejected")
+        && check(!compiles("r when 'NO SUCH VAR' > 0"), "unknown SimVars must be rejected")
+        && check(!compiles("r when 'PLANE ALT ABOVE GROUND > 0"), "unterminated quotes must be rejected")
+        && check(!compiles("r when (1 > 0"), "unbalanced parentheses must be rejected")
+        && check(!compiles("r when 1 > 0 for"), "'for' needs a duration")
+        && check(!compiles("r when 1 > 0 for -1s"), "negative durations must be rejected")
+        && check(!compiles("r when 1 $ 0"), "unknown characters must be rejected")
+        && check(!compiles("r when 1 > 0 extra"), "trailing tokens must be rejected")
+        && check(!compiles("r when 1 > 0\nr when 2 > 0"), "duplicate names in one source must be rejected")
+        && check(compiles("r when " + nested(AlertEngine::MaxStackDepth)), "expressions up to the stack depth must compile")
+        && check(!compiles("r when " + nested(AlertEngine::MaxStackDepth + 1)), "expressions beyond the stack depth must be rejected");
+}
+
+bool testExpressions()
+{
+    return check(holds("1 + 2 * 3 == 7"), "* binds tighter than +")
+        && check(holds("(1 + 2) * 3 == 9"), "parentheses group")
+        && check(holds("10 / 4 == 2.5 and 7 - 2 - 1 == 4"), "division and left-associative subtraction")
+        && check(holds("-2 * -3 == 6 and - eng_n1_1 == -42"), "unary minus")
+        && check(holds("abs(100 - plane_alt_above_ground) == 700"), "abs")
+        && check(!holds("not 0 and 0"), "not binds tighter than and")
+        && check(holds("1 or 0 and 0") && holds("1 || 0 && 0"), "and binds tighter than or")
+        && check(holds("!(1 < 0) and 2 >= 2 and 2 <= 2 and 3 != 2"), "comparisons")
+        && check(holds("'Plane Alt Above Ground' > 500 and gear_handle_position == 1"), "SimVar names are case insensitive")
+        && check(holds("true") && !holds("false"), "boolean constants")
+        && check(!holds("plane_alt_above_ground < 500"), "fields read the evaluated data");
+}
+
+bool testDebounce()
+{
+    AlertEngine engine;
+    engine.compile("low when plane_alt_above_ground < 500 for 2s", "test");
+    const AircraftData low = makeData(400.0f, 0.0f);
+    const AircraftData high = makeData(800.0f, 0.0f);
+
+    const bool waits = engine.evaluate(low, AllFields, 10 * Second).empty() && !engine.isActive(0)
+        && engine.nextDeadline() == 12 * Second;
+    const bool early = engine.evaluate(low, 0, 11 * Second).empty() && !engine.isActive(0);
+    const bool fires = engine.evaluate(low, 0, 12 * Second).size() == 1 && engine.isActive(0) && engine.nextDeadline() == 0;
+    // Without a clear condition the rule clears as soon as it no longer holds
+    const bool clears = engine.evaluate(high, AllFields, 13 * Second).size() == 1 && !engine.isActive(0);
+
+    // A blip shorter than the duration does not fire and stops the timer
+    engine.evaluate(low, AllFields, 20 * Second);
+    engine.evaluate(high, AllFields, 21 * Second);
+    const bool blip = engine.nextDeadline() == 0 && engine.evaluate(high, 0, 23 * Second).empty() && !engine.isActive(0);
+
+    // Unrelated fields do not re-run the rule
+    engine.evaluate(low, AllFields, 30 * Second);
+    const std::uint64_t n1Only = std::uint64_t(1) << AircraftSchema::eng_n1_1;
+    const bool unrelated = engine.evaluate(high, n1Only, 31 * Second).empty() && engine.nextDeadline() == 32 * Second;
+
+    return check(waits, "a debounced rule must start a timer instead of firing")
+        && check(early, "the rule must not fire before its deadline")
+        && check(fires, "the rule must fire at its deadline")
+        && check(clears, "the rule must clear when the condition stops holding")
+        && check(blip, "a short blip must not fire")
+        && check(unrelated, "only rules reading a changed field are re-run");
+}
+
+bool testHysteresis()
+{
+    AlertEngine engine;
+    engine.compile("spool when eng_n1_1 > 90 clear when eng_n1_1 < 80 for 1s", "test");
+
+    const bool sets = engine.evaluate(makeData(0.0f, 95.0f), AllFields, Second).size() == 1 && engine.isActive(0);
+    // Between the thresholds the rule stays active
+    const bool holdsBand = engine.evaluate(makeData(0.0f, 85.0f), AllFields, 2 * Second).empty() && engine.isActive(0)
+        && engine.nextDeadline() == 0;
+    const bool clearPending = engine.evaluate(makeData(0.0f, 70.0f), AllFields, 3 * Second).empty() && engine.isActive(0)
+        && engine.nextDeadline() == 4 * Second;
+    const bool clears = engine.evaluate(makeData(0.0f, 70.0f), 0, 4 * Second).size() == 1 && !engine.isActive(0);
+    // Below the set threshold it stays clear
+    const bool staysClear = engine.evaluate(makeData(0.0f, 85.0f), AllFields, 5 * Second).empty() && !engine.isActive(0);
+
+    return check(sets, "the rule must set above its threshold")
+        && check(holdsBand, "the rule must stay active between the thresholds")
+        && check(clearPending, "the clear condition must be debounced")
+        && check(clears, "the rule must clear once the clear condition held")
+        && check(staysClear, "the rule must not set again between the thresholds");
+}
+
+bool testReplacement()
+{
+    AlertEngine engine;
+    engine.compile("a when eng_n1_1 > 50\nb when eng_n1_1 > 10", "test");
+    engine.evaluate(makeData(0.0f, 60.0f), AllFields, Second);
+    const bool bothActive = engine.isActive(0) && engine.isActive(1);
+
+    const bool replaced = engine.compile("a \"replaced\" when eng_n1_1 > 70 for 1s", "test") && engine.ruleCount() == 2
+        && engine.find("a") == 0 && engine.rule(0).message == "replaced";
+    const bool startsOver = !engine.isActive(0) && engine.isActive(1);
+    const bool newCondition = engine.evaluate(makeData(0.0f, 60.0f), AllFields, 2 * Second).empty() && !engine.isActive(0);
+    engine.evaluate(makeData(0.0f, 75.0f), AllFields, 3 * Second);
+    const bool newDelay = engine.nextDeadline() == 4 * Second && engine.evaluate(makeData(0.0f, 75.0f), 0, 4 * Second).size() == 1;
+
+    engine.reset();
+    const bool reset = !engine.isActive(0) && !engine.isActive(1) && engine.nextDeadline() == 0;
+
+    return check(bothActive, "rules must evaluate independently")
+        && check(replaced, "a rule with an existing name must replace it")
+        && check(startsOver, "a replaced rule must start over inactive")
+        && check(newCondition, "a replaced rule must use its new condition")
+        && check(newDelay, "a replaced rule must use its new duration")
+        && check(reset, "reset must deactivate every rule");
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = testCompileErrors();
+    ok = testExpressions() && ok;
+    ok = testDebounce() && ok;
+    ok = testHysteresis() && ok;
+    ok = testReplacement() && ok;
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// Round-trips recorded chunks, headers and the index through the .fdr
+// codecs, and feeds them non-finite values and truncated or corrupt input.
+
+#include "FlightDataFormat.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace FlightData;
+
+namespace {
+
+constexpr std::size_t SampleCount = 500;
+
+bool check(bool condition, const char *message)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message);
+    }
+    return condition;
+}
+
+const std::vector<Channel> &testChannels()
+{
+    static const std::vector<Channel> channels = {
+        { "flag", Codec::Xor, 0.0 },
+        { "smooth", Codec::QuantizedDelta, 0.001 },
+        { "raw", Codec::Xor, 0.0 },
+    };
+    return channels;
+}
+
+// Jittered 60 Hz timestamps and a mix of steady, smooth and noisy columns
+void makeSamples(std::vector<std::int64_t> &timestamps, std::vector<double> &values)
+{
+    timestamps.resize(SampleCount);
+    values.resize(SampleCount * 3);
+    std::int64_t t = 0;
+    for (std::size_t i = 0; i < SampleCount; ++i) {
+        t += 16667 + static_cast<std::int64_t>((i * 7919) % 2000) - 1000;
+        timestamps[i] = t;
+        values[i * 3] = (i / 100) % 2;
+        values[i * 3 + 1] = 1000.0 * std::sin(i * 0.01);
+        values[i * 3 + 2] = std::cos(i * 0.37) * 1e6 + i;
+    }
+}
+
+bool decode(const std::vector<std::uint8_t> &chunk, std::size_t size,
+            std::vector<std::int64_t> &timestamps, std::vector<double> &values)
+{
+    ChunkHeader header;
+    return size >= ChunkHeaderSize
+        && readChunkHeader(chunk.data(), size, header)
+        && decodeChunkPayload(chunk.data() + ChunkHeaderSize, size - ChunkHeaderSize, header, testChannels(), timestamps, values);
+}
+
+bool testChunkRoundTrip()
+{
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> values;
+    makeSamples(timestamps, values);
+    std::vector<std::uint8_t> chunk;
+    encodeChunk(timestamps.data(), values.data(), SampleCount, testChannels(), chunk);
+
+    std::vector<std::int64_t> decodedTimestamps;
+    std::vector<double> decodedValues;
+    if (!check(decode(chunk, chunk.size(), decodedTimestamps, decodedValues), "a chunk must decode")) {
+        return false;
+    }
+    bool exact = decodedTimestamps == timestamps;
+    bool quantized = true;
+    for (std::size_t i = 0; i < SampleCount; ++i) {
+        exact &= decodedValues[i * 3] == values[i * 3] && decodedValues[i * 3 + 2] == values[i * 3 + 2];
+        quantized &= std::fabs(decodedValues[i * 3 + 1] - values[i * 3 + 1]) <= 0.0005 + 1e-9;
+    }
+    return check(exact, "timestamps and XOR columns must round-trip exactly")
+        && check(quantized, "quantized columns must stay within half a resolution step")
+        && check(chunk.size() < SampleCount * 3 * sizeof(double) / 2, "chunks must compress");
+}
+
+bool testNonFiniteValues()
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::int64_t timestamps[4] = { 0, 16000, 33000, 50000 };
+    const double values[12] = {
+        1.0, nan, nan,
+        0.0, inf, inf,
+        1.0, -inf, -inf,
+        0.0, 2.5, 1e300,
+    };
+    std::vector<std::uint8_t> chunk;
+    encodeChunk(timestamps, values, 4, testChannels(), chunk);
+
+    std::vector<std::int64_t> decodedTimestamps;
+    std::vector<double> decoded;
+    if (!check(decode(chunk, chunk.size(), decodedTimestamps, decoded), "non-finite samples must not break a chunk")) {
+        return false;
+    }
+    return check(decoded[1] == 0.0, "NaN is quantized to zero")
+        && check(decoded[4] > 1e12 && std::isfinite(decoded[4]), "+inf is clamped")
+        && check(decoded[7] < -1e12 && std::isfinite(decoded[7]), "-inf is clamped")
+        && check(std::fabs(decoded[10] - 2.5) < 1e-9, "samples after non-finite ones are unaffected")
+        && check(std::isnan(decoded[2]) && decoded[5] == inf && decoded[8] == -inf && decoded[11] == 1e300,
+                 "XOR columns keep non-finite values");
+}
+
+bool testCorruptChunks()
+{
+    std::vector<std::int64_t> timestamps;
+    std::vector<double> values;
+    makeSamples(timestamps, values);
+    std::vector<std::uint8_t> chunk;
+    encodeChunk(timestamps.data(), values.data(), SampleCount, testChannels(), chunk);
+
+    std::vector<std::int64_t> decodedTimestamps;
+    std::vector<double> decodedValues;
+    bool truncated = true;
+    for (std::size_t size = 0; size < chunk.size(); size += 7) {
+        truncated &= !decode(chunk, size, decodedTimestamps, decodedValues);
+    }
+
+    ChunkHeader header;
+    readChunkHeader(chunk.data(), chunk.size(), header);
+    const std::uint8_t *payload = chunk.data() + ChunkHeaderSize;
+    const std::size_t payloadSize = chunk.size() - ChunkHeaderSize;
+    ChunkHeader huge = header;
+    huge.sampleCount = std::numeric_limits<std::uint32_t>::max();
+    ChunkHeader empty = header;
+    empty.sampleCount = 0;
+
+    std::vector<std::uint8_t> badColumn = chunk;
+    const std::uint32_t columnSize = std::numeric_limits<std::uint32_t>::max();
+    std::memcpy(badColumn.data() + ChunkHeaderSize, &columnSize, sizeof(columnSize));
+
+    return check(truncated, "truncated chunks must be rejected")
+        && check(!decodeChunkPayload(payload, payloadSize, huge, testChannels(), decodedTimestamps, decodedValues),
+                 "a sample count the payload cannot hold must be rejected")
+        && check(!decodeChunkPayload(payload, payloadSize, empty, testChannels(), decodedTimestamps, decodedValues),
+                 "empty chunks must be rejected")
+        && check(!decode(badColumn, badColumn.size(), decodedTimestamps, decodedValues), "oversized columns must be rejected");
+}
+
+bool testFileHeader()
+{
+    FileHeader header;
+    header.startUnixMicroseconds = 1700000000000000;
+    header.channels = testChannels();
+    std::vector<std::uint8_t> bytes;
+    writeFileHeader(header, bytes);
+
+    FileHeader read;
+    const bool ok = readFileHeader(bytes.data(), bytes.size(), read) == bytes.size()
+        && read.startUnixMicroseconds == header.startUnixMicroseconds && read.channels.size() == 3
+        && read.channels[1].name == "smooth" && read.channels[1].codec == Codec::QuantizedDelta;
+
+    bool truncated = true;
+    for (std::size_t size = 0; size < bytes.size(); ++size) {
+        truncated &= readFileHeader(bytes.data(), size, read) == 0;
+    }
+
+    FileHeader zeroResolution = header;
+    zeroResolution.channels[1].resolution = 0.0;
+    std::vector<std::uint8_t> zeroBytes;
+    writeFileHeader(zeroResolution, zeroBytes);
+
+    // Codec byte of the last channel, followed by its 8 byte resolution
+    std::vector<std::uint8_t> badCodec = bytes;
+    badCodec[badCodec.size() - sizeof(double) - 1] = 7;
+
+    return check(ok, "a file header must round-trip")
+        && check(truncated, "truncated file headers must be rejected")
+        && check(readFileHeader(zeroBytes.data(), zeroBytes.size(), read) == 0, "a zero resolution must be rejected")
+        && check(readFileHeader(badCodec.data(), badCodec.size(), read) == 0, "unknown codecs must be rejected");
+}
+
+bool testIndex()
+{
+    // Stand-in chunk bytes followed by the index and its trailer
+    std::vector<std::uint8_t> file(100, 0xAB);
+    std::vector<IndexEntry> entries(3);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].firstTimestamp = static_cast<std::int64_t>(i) * 1000;
+        entries[i].lastTimestamp = static_cast<std::int64_t>(i) * 1000 + 999;
+        entries[i].offset = 10 + i * 30;
+        entries[i].sampleCount = 60;
+    }
+    writeIndex(entries, file.size(), file);
+
+    std::vector<IndexEntry> read;
+    const bool ok = readIndex(file.data(), file.size(), read) && read.size() == 3
+        && read[2].offset == entries[2].offset && read[2].lastTimestamp == entries[2].lastTimestamp
+        && read[1].sampleCount == 60;
+
+    // Trailer: u64 index offset, u32 entry count, magic
+    std::vector<std::uint8_t> wrapping = file;
+    const std::uint64_t hugeOffset = 0xffffffffffffffecULL;
+    std::memcpy(wrapping.data() + wrapping.size() - IndexTrailerSize, &hugeOffset, sizeof(hugeOffset));
+    std::vector<std::uint8_t> tooMany = file;
+    const std::uint32_t entryCount = 1000000;
+    std::memcpy(tooMany.data() + tooMany.size() - IndexTrailerSize + sizeof(std::uint64_t), &entryCount, sizeof(entryCount));
+    std::vector<std::uint8_t> truncated(file.end() - IndexTrailerSize, file.end());
+
+    return check(ok, "the index must round-trip")
+        && check(!readIndex(wrapping.data(), wrapping.size(), read), "a wrapping index offset must be rejected")
+        && check(!readIndex(tooMany.data(), tooMany.size(), read), "an entry count beyond the file must be rejected")
+        && check(!readIndex(truncated.data(), truncated.size(), read), "a trailer without its index must be rejected")
+        && check(!readIndex(file.data(), IndexTrailerSize - 1, read), "a file shorter than the trailer has no index");
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = testChunkRoundTrip();
+    ok = testNonFiniteValues() && ok;
+    ok = testCorruptChunks() && ok;
+    ok = testFileHeader() && ok;
+    ok = testIndex() && ok;
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
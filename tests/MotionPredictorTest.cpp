@@ -0,0 +1,98 @@
+// Checks that MotionPredictor extrapolates between samples but returns to
+// the last received values once the feed goes quiet, as a changed-only
+// SimConnect feed does when nothing changes.
+
+#include "MotionPredictor.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+constexpr std::int64_t IntervalNs = 16666667; // 60 Hz feed
+constexpr float TurnRate = 15.0f; // degrees per second
+
+bool check(bool condition, const char *message)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message);
+    }
+    return condition;
+}
+
+bool near(float a, float b)
+{
+    return std::fabs(a - b) < 1e-3f;
+}
+
+// Feeds a steady turn and returns the time of the last sample.
+std::int64_t feedTurn(MotionPredictor &predictor, int samples, float &lastHeading)
+{
+    AircraftData data {};
+    std::int64_t t = 1000000000;
+    for (int i = 0; i < samples; ++i) {
+        t += IntervalNs;
+        data.received_ns = t;
+        data.plane_heading_degrees_true = 20.0f + TurnRate * i * (IntervalNs * 1e-9f);
+        data.eng_n1_1 = 60.0f + 0.5f * i;
+        predictor.addSample(data);
+    }
+    lastHeading = data.plane_heading_degrees_true;
+    return t;
+}
+
+bool testExtrapolatesBetweenSamples()
+{
+    MotionPredictor predictor(100000000);
+    float lastHeading = 0.0f;
+    const std::int64_t last = feedTurn(predictor, 20, lastHeading);
+
+    const float halfway = predictor.predict(last + IntervalNs / 2).plane_heading_degrees_true;
+    const float expected = lastHeading + TurnRate * (IntervalNs / 2 * 1e-9f);
+    return check(predictor.isActive(last + IntervalNs / 2), "prediction must run within one interval")
+        && check(near(halfway, expected), "halfway to the next sample must follow the turn");
+}
+
+bool testSilentFeedReturnsToLastSample()
+{
+    MotionPredictor predictor(100000000);
+    float lastHeading = 0.0f;
+    const std::int64_t last = feedTurn(predictor, 20, lastHeading);
+
+    // Never beyond the slope over ExtrapolationIntervals (1.5) intervals
+    bool bounded = true;
+    for (std::int64_t t = last; t < last + 4 * IntervalNs; t += IntervalNs / 8) {
+        const float heading = predictor.predict(t).plane_heading_degrees_true;
+        bounded &= heading >= lastHeading - 1e-3f && heading <= lastHeading + TurnRate * 1.5f * (IntervalNs * 1e-9f) + 1e-3f;
+    }
+
+    bool settled = true;
+    for (std::int64_t offset : { std::int64_t(3 * IntervalNs), std::int64_t(100000000), std::int64_t(1000000000), std::int64_t(60000000000) }) {
+        const AircraftData predicted = predictor.predict(last + offset);
+        settled &= near(predicted.plane_heading_degrees_true, lastHeading) && near(predicted.eng_n1_1, 60.0f + 0.5f * 19);
+        settled &= !predictor.isActive(last + offset);
+    }
+    return check(bounded, "extrapolation must stop about one interval past the last sample")
+        && check(settled, "a silent feed must end on the last received values");
+}
+
+bool testHorizonZeroShowsSamples()
+{
+    MotionPredictor predictor(0);
+    float lastHeading = 0.0f;
+    const std::int64_t last = feedTurn(predictor, 20, lastHeading);
+    return check(!predictor.isActive(last + IntervalNs / 2), "horizon 0 disables prediction")
+        && check(near(predictor.predict(last + IntervalNs / 2).plane_heading_degrees_true, lastHeading),
+                 "horizon 0 shows the sample as received");
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = testExtrapolatesBetweenSamples();
+    ok = testSilentFeedReturnsToLastSample() && ok;
+    ok = testHorizonZeroShowsSamples() && ok;
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
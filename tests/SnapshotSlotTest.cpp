@@ -0,0 +1,112 @@
+// Checks the SnapshotSlot handoff against a fake producer thread: every
+// word of the published payload carries the same counter, so a torn read
+// shows up as mixed counters. Needs neither Qt nor SimConnect.
+
+#include "SnapshotSlot.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Stamped {
+    std::uint64_t counter;
+    std::uint64_t words[15];
+};
+
+bool check(bool condition, const char *message)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message);
+    }
+    return condition;
+}
+
+bool testEmptySlot()
+{
+    SnapshotSlot<Stamped> slot;
+    Stamped value {};
+    std::uint64_t version = 1;
+    return check(!slot.load(value, version), "load() before the first publish must fail")
+        && check(version == 0, "empty slot must report version 0")
+        && check(slot.version() == 0, "empty slot must have version 0");
+}
+
+bool testConcurrentReaders()
+{
+    constexpr std::uint64_t PublishCount = 2000000;
+    constexpr int ReaderCount = 3;
+
+    SnapshotSlot<Stamped> slot;
+    std::atomic<bool> done { false };
+    std::atomic<int> failures { 0 };
+    std::atomic<std::uint64_t> reads { 0 };
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < ReaderCount; ++r) {
+        readers.emplace_back([&] {
+            std::uint64_t lastVersion = 0;
+            std::uint64_t lastCounter = 0;
+            std::uint64_t count = 0;
+            Stamped value {};
+            for (;;) {
+                const bool finished = done.load(std::memory_order_acquire);
+                std::uint64_t version = 0;
+                if (slot.load(value, version)) {
+                    ++count;
+                    bool torn = false;
+                    for (std::uint64_t word : value.words) {
+                        torn |= word != value.counter;
+                    }
+                    // The producer publishes counter n as version n
+                    if (torn || version != value.counter || version < lastVersion || value.counter < lastCounter) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    lastVersion = version;
+                    lastCounter = value.counter;
+                }
+                if (finished) {
+                    break;
+                }
+            }
+            if (lastVersion != PublishCount) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+            }
+            reads.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+
+    std::thread producer([&] {
+        Stamped value {};
+        for (std::uint64_t counter = 1; counter <= PublishCount; ++counter) {
+            value.counter = counter;
+            for (std::uint64_t &word : value.words) {
+                word = counter;
+            }
+            slot.publish(value);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    producer.join();
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    std::printf("%llu publishes, %llu reads\n", static_cast<unsigned long long>(PublishCount),
+                static_cast<unsigned long long>(reads.load()));
+    return check(failures.load() == 0, "readers saw a torn value, a version going backwards or missed the last value")
+        && check(slot.version() == PublishCount, "version must equal the number of publishes");
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = testEmptySlot();
+    ok = testConcurrentReaders() && ok;
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+// Round-trips telemetry frames against acknowledged base states and feeds
+// the message framing partial buffers and corrupt length prefixes.
+
+#include "TelemetryProtocol.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+using namespace TelemetryProtocol;
+
+namespace {
+
+constexpr std::size_t Corrupt = std::numeric_limits<std::size_t>::max();
+
+bool check(bool condition, const char *message)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message);
+    }
+    return condition;
+}
+
+State makeState(std::int64_t seed)
+{
+    State state {};
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        state[i] = (static_cast<std::int64_t>(i) - 5) * seed * 37;
+    }
+    return state;
+}
+
+bool testFrameRoundTrip()
+{
+    const State base = makeState(1000);
+    State state = base;
+    state[0] += 1;
+    state[3] -= 70000;
+    state[AircraftSchema::FieldCount - 1] += std::int64_t(1) << 40;
+
+    FrameHeader header;
+    header.sequence = 42;
+    header.baseSequence = 40;
+    header.sourceNs = -123456789;
+    header.sentNs = 987654321012;
+    header.dropped = 3;
+    std::vector<std::uint8_t> out;
+    writeFrame(header, base, state, out);
+
+    Message message;
+    if (!check(nextMessage(out.data(), out.size(), message) == out.size(), "a frame must be one complete message")) {
+        return false;
+    }
+    FrameHeader peeked;
+    FrameHeader decodedHeader;
+    State decoded = base;
+    const bool ok = readFrameHeader(message, peeked) && readFrame(message, decodedHeader, decoded);
+
+    std::vector<std::uint8_t> unchanged;
+    writeFrame(header, base, base, unchanged);
+    State zeroBased {};
+    std::vector<std::uint8_t> full;
+    writeFrame(header, zeroBased, state, full);
+    Message fullMessage;
+    nextMessage(full.data(), full.size(), fullMessage);
+    const bool fullOk = readFrame(fullMessage, decodedHeader, zeroBased);
+
+    return check(ok, "a frame must decode")
+        && check(peeked.baseSequence == 40 && decodedHeader.sequence == 42, "sequences must round-trip")
+        && check(decodedHeader.sourceNs == header.sourceNs && decodedHeader.sentNs == header.sentNs, "times must round-trip")
+        && check(decodedHeader.dropped == 3, "the dropped count must round-trip")
+        && check(decoded == state, "the state must be rebuilt from its base")
+        && check(fullOk && zeroBased == state, "a frame against base 0 must carry the full state")
+        && check(unchanged.size() == MessageHeaderSize + 4 + 4 + 8 + 8 + 4 + 8, "unchanged fields must not be sent");
+}
+
+bool testQuantize()
+{
+    AircraftData data {};
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        AircraftSchema::setValue(data, i, AircraftSchema::Fields[i].isInteger ? -3.0 * i : 12.3456 * i - 40.0);
+    }
+    State state;
+    quantize(data, state);
+    AircraftData restored {};
+    dequantize(state, restored);
+
+    bool close = true;
+    for (std::size_t i = 0; i < AircraftSchema::FieldCount; ++i) {
+        const double original = AircraftSchema::value(data, i);
+        const double error = std::fabs(AircraftSchema::value(restored, i) - original);
+        if (AircraftSchema::Fields[i].isInteger) {
+            close &= error == 0.0;
+        } else {
+            close &= error <= AircraftSchema::Fields[i].epsilon / 2 + std::fabs(original) * 1e-6;
+        }
+    }
+    return check(close, "quantized fields must come back within half an epsilon");
+}
+
+bool testFraming()
+{
+    std::vector<std::uint8_t> stream;
+    writeHello({ Version, 30 }, stream);
+    writeAck(7, stream);
+    writeSetRate(5, stream);
+    Welcome welcome;
+    welcome.fieldCount = AircraftSchema::FieldCount;
+    welcome.schemaHash = schemaHash();
+    writeWelcome(welcome, stream);
+
+    Message message;
+    bool partial = true;
+    const std::size_t first = nextMessage(stream.data(), stream.size(), message);
+    for (std::size_t size = 0; size < first; ++size) {
+        partial &= nextMessage(stream.data(), size, message) == 0;
+    }
+
+    Hello hello;
+    std::uint32_t sequence = 0;
+    std::uint16_t rate = 0;
+    Welcome readBack;
+    std::size_t offset = 0;
+    std::size_t used = nextMessage(stream.data(), stream.size(), message);
+    const bool helloOk = readHello(message, hello) && hello.rateHz == 30 && hello.version == Version;
+    offset += used;
+    used = nextMessage(stream.data() + offset, stream.size() - offset, message);
+    const bool ackOk = !readHello(message, hello) && readAck(message, sequence) && sequence == 7;
+    offset += used;
+    used = nextMessage(stream.data() + offset, stream.size() - offset, message);
+    const bool rateOk = readSetRate(message, rate) && rate == 5;
+    offset += used;
+    used = nextMessage(stream.data() + offset, stream.size() - offset, message);
+    const bool welcomeOk = readWelcome(message, readBack) && readBack.schemaHash == schemaHash()
+        && readBack.fieldCount == AircraftSchema::FieldCount;
+    offset += used;
+
+    const std::uint8_t empty[] = { 0, 0, 1 };
+    const std::uint8_t oversized[] = { 0x01, 0x04, 17 }; // 1025
+    const std::uint8_t maximal[] = { 0x00, 0x04, 17 };   // 1024, not complete yet
+
+    return check(partial, "partial messages must wait for more data")
+        && check(helloOk && ackOk && rateOk && welcomeOk, "control messages must round-trip")
+        && check(offset == stream.size(), "back to back messages must be consumed exactly")
+        && check(nextMessage(empty, sizeof(empty), message) == Corrupt, "a zero length prefix is corrupt")
+        && check(nextMessage(oversized, sizeof(oversized), message) == Corrupt, "an oversized length prefix is corrupt")
+        && check(nextMessage(maximal, sizeof(maximal), message) == 0, "a maximal message is incomplete, not corrupt");
+}
+
+bool testMalformedFrames()
+{
+    const State base {};
+    State state {};
+    state[1] = 1000000; // multi-byte varint
+    std::vector<std::uint8_t> out;
+    writeFrame(FrameHeader(), base, state, out);
+
+    // Drop the last varint byte and shorten the length prefix to match
+    std::vector<std::uint8_t> truncated(out.begin(), out.end() - 1);
+    --truncated[0];
+    // One byte of trailing garbage inside the message
+    std::vector<std::uint8_t> padded = out;
+    padded.push_back(0);
+    ++padded[0];
+    // A header cut short
+    std::vector<std::uint8_t> shortHeader(out.begin(), out.begin() + MessageHeaderSize + 10);
+    shortHeader[0] = 11;
+
+    FrameHeader header;
+    Message message;
+    State decoded {};
+    bool rejected = true;
+    for (const std::vector<std::uint8_t> *bytes : { &truncated, &padded }) {
+        rejected &= nextMessage(bytes->data(), bytes->size(), message) == bytes->size()
+            && !readFrame(message, header, decoded);
+    }
+    rejected &= nextMessage(shortHeader.data(), shortHeader.size(), message) == shortHeader.size()
+        && !readFrameHeader(message, header) && !readFrame(message, header, decoded);
+
+    std::vector<std::uint8_t> ack;
+    writeAck(1, ack);
+    nextMessage(ack.data(), ack.size(), message);
+    return check(rejected, "truncated, padded and short frames must be rejected")
+        && check(!readFrame(message, header, decoded), "other message types are not frames");
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = testFrameRoundTrip();
+    ok = testQuantize() && ok;
+    ok = testFraming() && ok;
+    ok = testMalformedFrames() && ok;
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "TelemetryProtocol.h"
+
+// Subscribes to a running dashboard's telemetry server with one or more
+// connections, decodes every frame and reports throughput, bytes, frames
+// the server dropped for us, and lag (source receive time and send time to
+// decode). Times are only comparable when client and dashboard share a host.
+
+namespace {
+
+struct Totals {
+    quint64 frames = 0;
+    quint64 bytes = 0;
+    quint64 skipped = 0; // frames the server dropped for us
+    quint64 errors = 0;
+    LatencyHistogram sourceLag;
+    LatencyHistogram networkLag;
+};
+
+class Subscriber
+{
+public:
+    Subscriber(Totals &totals, int rateHz)
+        : m_totals(totals)
+        , m_rate_hz(rateHz)
+    {
+        QObject::connect(&m_socket, &QTcpSocket::connected, [this]() { onConnected(); });
+        QObject::connect(&m_socket, &QTcpSocket::readyRead, [this]() { onReadyRead(); });
+        QObject::connect(&m_socket, &QTcpSocket::errorOccurred, [this]() {
+            std::fprintf(stderr, "Connection error: %s\n", qPrintable(m_socket.errorString()));
+            ++m_totals.errors;
+        });
+    }
+
+    void connectTo(const QString &host, quint16 port) { m_socket.connectToHost(host, port); }
+
+private:
+    void onConnected()
+    {
+        m_socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        std::vector<std::uint8_t> out;
+        TelemetryProtocol::writeHello({ TelemetryProtocol::Version, static_cast<std::uint16_t>(m_rate_hz) }, out);
+        m_socket.write(reinterpret_cast<const char *>(out.data()), static_cast<qint64>(out.size()));
+    }
+
+    void onReadyRead()
+    {
+        using namespace TelemetryProtocol;
+
+        const QByteArray bytes = m_socket.readAll();
+        m_totals.bytes += static_cast<quint64>(bytes.size());
+        m_received += bytes;
+
+        const auto *data = reinterpret_cast<const std::uint8_t *>(m_received.constData());
+        const std::size_t size = static_cast<std::size_t>(m_received.size());
+        std::size_t offset = 0;
+        std::vector<std::uint8_t> acks;
+        Message message;
+        while (std::size_t length = nextMessage(data + offset, size - offset, message)) {
+            if (length == SIZE_MAX) {
+                fail("corrupt stream");
+                return;
+            }
+            offset += length;
+
+            Welcome welcome;
+            if (readWelcome(message, welcome)) {
+                if (welcome.schemaHash != schemaHash() || welcome.fieldCount != AircraftSchema::FieldCount) {
+                    fail("schema mismatch");
+                    return;
+                }
+                continue;
+            }
+
+            // Decode against the base the server chose, which we must still hold
+            FrameHeader header;
+            if (!readFrameHeader(message, header)) {
+                continue; // not a frame; newer servers may send more types
+            }
+            State state {};
+            if (header.baseSequence) {
+                const std::uint32_t slot = header.baseSequence % AckWindow;
+                if (m_sequences[slot] != header.baseSequence) {
+                    fail("frame references an unknown base");
+                    return;
+                }
+                state = m_states[slot];
+            }
+            if (!readFrame(message, header, state)) {
+                fail("malformed frame");
+                return;
+            }
+            m_sequences[header.sequence % AckWindow] = header.sequence;
+            m_states[header.sequence % AckWindow] = state;
+            writeAck(header.sequence, acks);
+
+            const std::int64_t now = LatencyHistogram::now();
+            if (header.sourceNs) {
+                m_totals.sourceLag.record(now - header.sourceNs);
+            }
+            m_totals.networkLag.record(now - header.sentNs);
+            m_totals.skipped += header.dropped;
+            ++m_totals.frames;
+        }
+        m_received.remove(0, static_cast<qsizetype>(offset));
+        if (!acks.empty()) {
+            m_socket.write(reinterpret_cast<const char *>(acks.data()), static_cast<qint64>(acks.size()));
+        }
+    }
+
+    void fail(const char *reason)
+    {
+        std::fprintf(stderr, "Closing connection: %s\n", reason);
+        ++m_totals.errors;
+        m_socket.abort();
+    }
+
+    Totals &m_totals;
+    int m_rate_hz;
+    QTcpSocket m_socket;
+    QByteArray m_received;
+    std::array<std::uint32_t, TelemetryProtocol::AckWindow> m_sequences {};
+    std::array<TelemetryProtocol::State, TelemetryProtocol::AckWindow> m_states {};
+};
+
+void printLag(const char *name, const LatencyHistogram &histogram)
+{
+    const LatencyHistogram::Summary summary = histogram.summary();
+    std::printf("  %-8s p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms\n",
+                name, summary.p50 / 1e6, summary.p99 / 1e6, summary.max / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "host", "Dashboard host.", "host", "127.0.0.1" },
+        { "port", "Telemetry server port.", "port" },
+        { "clients", "Number of simultaneous subscriptions.", "count", "1" },
+        { "rate", "Update rate each subscription asks for, in Hz.", "hz", "60" },
+        { "duration", "Measurement time in seconds.", "seconds", "10" },
+    });
+    parser.process(app);
+
+    const quint16 port = parser.value("port").toUShort();
+    if (!port) {
+        std::fprintf(stderr, "--port is required\n");
+        return 1;
+    }
+    const int clients = qMax(1, parser.value("clients").toInt());
+    const int rateHz = qMax(1, parser.value("rate").toInt());
+    const int durationSeconds = qMax(1, parser.value("duration").toInt());
+
+    Totals totals;
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    for (int i = 0; i < clients; ++i) {
+        subscribers.push_back(std::make_unique<Subscriber>(totals, rateHz));
+        subscribers.back()->connectTo(parser.value("host"), port);
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    QTimer::singleShot(durationSeconds * 1000, &app, &QCoreApplication::quit);
+    app.exec();
+
+    const double seconds = clock.nsecsElapsed() / 1e9;
+    std::printf("%d subscription(s) at %d Hz for %.1f s\n", clients, rateHz, seconds);
+    std::printf("  frames   %llu (%.1f/s per subscription), %llu skipped by the server\n",
+                totals.frames, totals.frames / seconds / clients, totals.skipped);
+    std::printf("  bytes    %llu (%.1f kB/s, %.1f B/frame)\n", totals.bytes, totals.bytes / seconds / 1024.0,
+                totals.frames ? static_cast<double>(totals.bytes) / totals.frames : 0.0);
+    printLag("source", totals.sourceLag);
+    printLag("network", totals.networkLag);
+    return totals.errors ? 1 : 0;
+}